@@ -0,0 +1,50 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Benchmark/CRPG_BenchmarkCharacter.h"
+
+// UE
+#include "GameFramework/CharacterMovementComponent.h"
+
+ACRPG_BenchmarkCharacter::ACRPG_BenchmarkCharacter()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// Only the gameplay tick is compared. Without a floor or controller, movement would only add the same noise to
+	// every run.
+	AutoPossessAI = EAutoPossessAI::Disabled;
+	GetCharacterMovement()->PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	GameplayState.Add();
+}
+
+void ACRPG_BenchmarkCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	CharacterTick::Update(GameplayState, DeltaSeconds, 0, 1);
+
+	const ECharacterTickEvents Events = GameplayState.Events[0];
+	if(EnumHasAnyFlags(Events, ECharacterTickEvents::Damaged))
+	{
+		ReceiveStatusEffectDamage(CharacterTick::ConsumeDamage(GameplayState, 0));
+	}
+
+	if(EnumHasAnyFlags(Events, ECharacterTickEvents::StatusExpired))
+	{
+		OnStatusEffectExpired();
+	}
+
+	if(EnumHasAnyFlags(Events, ECharacterTickEvents::ActionReady))
+	{
+		OnActionReady();
+	}
+}
+
+void ACRPG_BenchmarkCharacter::SetGameplayState(float ActionCooldown, float StatusTime, float StatusDamageRate)
+{
+	GameplayState.ActionCooldowns[0] = ActionCooldown;
+	GameplayState.StatusTimes[0] = StatusTime;
+	GameplayState.StatusDamageRates[0] = StatusDamageRate;
+}
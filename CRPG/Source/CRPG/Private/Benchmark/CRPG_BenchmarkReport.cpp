@@ -0,0 +1,147 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Benchmark/CRPG_BenchmarkReport.h"
+
+// UE
+#include "Dom/JsonObject.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCRPGBenchmark, Log, All);
+
+namespace BenchmarkReport
+{
+	// What a baseline was recorded on. Timings are only compared between runs on the same machine and configuration.
+	TSharedRef<FJsonObject> MakeMachineObject()
+	{
+		const TSharedRef<FJsonObject> MachineObject = MakeShared<FJsonObject>();
+		MachineObject->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+		MachineObject->SetNumberField(TEXT("cores"), FPlatformMisc::NumberOfCores());
+		MachineObject->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+		return MachineObject;
+	}
+
+	FString DescribeMachine(const FJsonObject& MachineObject)
+	{
+		return FString::Printf(TEXT("%s, %d cores, %s"), *MachineObject.GetStringField(TEXT("cpu")),
+			static_cast<int32>(MachineObject.GetNumberField(TEXT("cores"))), *MachineObject.GetStringField(TEXT("configuration")));
+	}
+}
+
+FBenchmarkReportSettings BenchmarkReport::ParseSettings(const TMap<FString, FString>& ParamValues, const TArray<FString>& Switches, const FString& Name)
+{
+	FBenchmarkReportSettings Settings;
+	
+	Settings.OutputPath = ParamValues.Contains(TEXT("Output"))
+		? ParamValues[TEXT("Output")]
+		: FPaths::ProjectSavedDir() / Name + TEXT("Benchmark.json");
+	Settings.BaselinePath = ParamValues.Contains(TEXT("Baseline"))
+		? ParamValues[TEXT("Baseline")]
+		: FPaths::ProjectDir() / TEXT("Benchmark") / Name + TEXT("Baseline.json");
+
+	if(const FString* ThresholdValue = ParamValues.Find(TEXT("Threshold")))
+	{
+		Settings.Threshold = FCString::Atod(**ThresholdValue);
+	}
+
+	Settings.bUpdateBaseline = Switches.Contains(TEXT("UpdateBaseline"));
+	return Settings;
+}
+
+int32 BenchmarkReport::Report(const FBenchmarkReportSettings& Settings, const TMap<FString, double>& Results, int64 Iterations)
+{
+	const TSharedRef<FJsonObject> ResultsObject = MakeShared<FJsonObject>();
+	ResultsObject->SetNumberField(TEXT("iterations"), static_cast<double>(Iterations));
+	ResultsObject->SetObjectField(TEXT("machine"), MakeMachineObject());
+
+	const TSharedRef<FJsonObject> KernelsObject = MakeShared<FJsonObject>();
+	for (const TPair<FString, double>& Result : Results)
+	{
+		KernelsObject->SetNumberField(Result.Key, Result.Value);
+		UE_LOG(LogCRPGBenchmark, Display, TEXT("%-28s %12.2f ns/iteration"), *Result.Key, Result.Value);
+	}
+	ResultsObject->SetObjectField(TEXT("nsPerIteration"), KernelsObject);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(ResultsObject, Writer);
+
+	if(!FFileHelper::SaveStringToFile(Json, *Settings.OutputPath))
+	{
+		UE_LOG(LogCRPGBenchmark, Error, TEXT("Failed to write %s."), *Settings.OutputPath);
+		return 1;
+	}
+
+	if(Settings.bUpdateBaseline)
+	{
+		if(!FFileHelper::SaveStringToFile(Json, *Settings.BaselinePath))
+		{
+			UE_LOG(LogCRPGBenchmark, Error, TEXT("Failed to write baseline %s."), *Settings.BaselinePath);
+			return 1;
+		}
+
+		UE_LOG(LogCRPGBenchmark, Display, TEXT("Updated baseline %s."), *Settings.BaselinePath);
+		return 0;
+	}
+
+	FString BaselineJson;
+	if(!FFileHelper::LoadFileToString(BaselineJson, *Settings.BaselinePath))
+	{
+		UE_LOG(LogCRPGBenchmark, Warning, TEXT("No baseline at %s, run with -UpdateBaseline to record one."), *Settings.BaselinePath);
+		return 0;
+	}
+
+	TSharedPtr<FJsonObject> BaselineObject;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BaselineJson);
+	const TSharedPtr<FJsonObject>* BaselineKernels = nullptr;
+	if(!FJsonSerializer::Deserialize(Reader, BaselineObject) || !BaselineObject.IsValid() || !BaselineObject->TryGetObjectField(TEXT("nsPerIteration"), BaselineKernels))
+	{
+		UE_LOG(LogCRPGBenchmark, Error, TEXT("Could not parse baseline %s."), *Settings.BaselinePath);
+		return 1;
+	}
+
+	const FString Machine = DescribeMachine(*MakeMachineObject());
+	const TSharedPtr<FJsonObject>* BaselineMachine = nullptr;
+	const FString RecordedMachine = BaselineObject->TryGetObjectField(TEXT("machine"), BaselineMachine)
+		? DescribeMachine(**BaselineMachine)
+		: TEXT("an unknown machine");
+	
+	const bool bSameMachine = RecordedMachine == Machine;
+	if(!bSameMachine)
+	{
+		UE_LOG(LogCRPGBenchmark, Warning, TEXT("Baseline %s was recorded on %s, this is %s. Changes are reported but don't fail the run."),
+			*Settings.BaselinePath, *RecordedMachine, *Machine);
+	}
+
+	bool bRegressed = false;
+	for (const TPair<FString, double>& Result : Results)
+	{
+		double BaselineValue = 0.0;
+		if(!(*BaselineKernels)->TryGetNumberField(Result.Key, BaselineValue) || BaselineValue <= 0.0)
+		{
+			UE_LOG(LogCRPGBenchmark, Warning, TEXT("%s has no baseline."), *Result.Key);
+			continue;
+		}
+
+		const double Change = Result.Value / BaselineValue - 1.0;
+		if(Change > Settings.Threshold)
+		{
+			if(bSameMachine)
+			{
+				UE_LOG(LogCRPGBenchmark, Error, TEXT("%s regressed by %.1f%% (%.2f ns, baseline %.2f ns)."), *Result.Key, Change * 100.0, Result.Value, BaselineValue);
+				bRegressed = true;
+			}
+			else
+			{
+				UE_LOG(LogCRPGBenchmark, Display, TEXT("%s is %.1f%% slower (%.2f ns, baseline %.2f ns)."), *Result.Key, Change * 100.0, Result.Value, BaselineValue);
+			}
+		}
+	}
+
+	return bRegressed ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Benchmark/CRPG_CameraKernelBenchmarkCommandlet.h"
+
+// CRPG
+#include "Benchmark/CRPG_BenchmarkReport.h"
+#include "Player/Camera/CRPG_CameraMoveHistory.h"
+#include "Player/Camera/CRPG_CameraSimulation.h"
+#include "Player/Camera/CRPG_CameraZoomTable.h"
+
+// UE
+#include "Components/SplineComponent.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCRPGCameraKernelBenchmark, Log, All);
+
+namespace CameraKernelBenchmark
+{
+	// Inputs are read from small tables so the compiler can't fold a kernel into a constant.
+	constexpr int32 NumInputs = 1024;
+	constexpr int32 InputMask = NumInputs - 1;
+}
+
+UCRPG_CameraKernelBenchmarkCommandlet::UCRPG_CameraKernelBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCRPG_CameraKernelBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamValues;
+	ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+	const int64 Iterations = ParamValues.Contains(TEXT("Iterations")) ? FMath::Max<int64>(FCString::Atoi64(*ParamValues[TEXT("Iterations")]), 1) : 5000000;
+	const FBenchmarkReportSettings Settings = BenchmarkReport::ParseSettings(ParamValues, Switches, TEXT("CameraKernel"));
+
+	return BenchmarkReport::Report(Settings, RunKernels(Iterations), Iterations);
+}
+
+TMap<FString, double> UCRPG_CameraKernelBenchmarkCommandlet::RunKernels(int64 Iterations) const
+{
+	using namespace CameraKernelBenchmark;
+	using BenchmarkReport::Time;
+
+	FRandomStream Random(1337);
+
+	TArray<float> Alphas;
+	TArray<FRotator> RotationsA;
+	TArray<FRotator> RotationsB;
+	for (int32 Index = 0; Index < NumInputs; ++Index)
+	{
+		Alphas.Add(Random.GetFraction());
+		RotationsA.Add(FRotator(Random.FRandRange(-90.f, 90.f), Random.FRandRange(-180.f, 180.f), 0.f));
+		RotationsB.Add(FRotator(Random.FRandRange(-90.f, 90.f), Random.FRandRange(-180.f, 180.f), 0.f));
+	}
+
+	// A full history, as on a client waiting on a slow connection.
+	FCameraMoveHistory MoveHistory;
+	MoveHistory.Init(64);
+	for (int32 Index = 0; Index < MoveHistory.GetCapacity(); ++Index)
+	{
+		MoveHistory.Add();
+	}
+	const uint32 OldestSequence = MoveHistory.GetNextSequence() - MoveHistory.Num();
+
+	// A zoom spline shaped like the default camera's, pulling up and back from the pivot.
+	USplineComponent* Spline = NewObject<USplineComponent>(GetTransientPackage());
+	Spline->ClearSplinePoints(false);
+	Spline->AddSplinePoint(FVector(-300.f, 0.f, 200.f), ESplineCoordinateSpace::Local, false);
+	Spline->AddSplinePoint(FVector(-900.f, 0.f, 900.f), ESplineCoordinateSpace::Local, false);
+	Spline->AddSplinePoint(FVector(-1200.f, 0.f, 2000.f), ESplineCoordinateSpace::Local, true);
+
+	FCameraZoomTable ZoomTable;
+	ZoomTable.Bake(*Spline, FTransform::Identity, FVector::ZeroVector, 128);
+
+	double Sink = 0.0;
+	TMap<FString, double> Results;
+
+	Results.Add(TEXT("EaseInOutCubic"), Time(Iterations, Sink, [&](int64 Iteration)
+	{
+		return CameraSimulation::EaseInOutCubic(Alphas[Iteration & InputMask]);
+	}));
+
+	Results.Add(TEXT("AngularDistance"), Time(Iterations, Sink, [&](int64 Iteration)
+	{
+		return CameraSimulation::GetAngularDistance(RotationsA[Iteration & InputMask], RotationsB[Iteration & InputMask]);
+	}));
+
+	Results.Add(TEXT("MoveHistoryFind"), Time(Iterations, Sink, [&](int64 Iteration)
+	{
+		const FCameraMoveData* Move = MoveHistory.Find(OldestSequence + static_cast<uint32>(Iteration & 63));
+		return Move ? static_cast<double>(Move->Sequence) : 0.0;
+	}));
+
+	Results.Add(TEXT("ZoomTableSample"), Time(Iterations, Sink, [&](int64 Iteration)
+	{
+		return ZoomTable.Sample(Alphas[Iteration & InputMask]).GetLocation().Z;
+	}));
+
+	// The per-zoom work the table replaced, kept as a reference point.
+	Results.Add(TEXT("ZoomSplineEvaluate"), Time(Iterations, Sink, [&](int64 Iteration)
+	{
+		const FVector Location = Spline->GetLocationAtTime(Alphas[Iteration & InputMask], ESplineCoordinateSpace::Local);
+		return Location.Z + (-Location).Rotation().Pitch;
+	}));
+
+	UE_LOG(LogCRPGCameraKernelBenchmark, Verbose, TEXT("Checksum %f"), Sink);
+	return Results;
+}
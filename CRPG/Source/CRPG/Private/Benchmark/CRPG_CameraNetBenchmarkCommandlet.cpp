@@ -0,0 +1,270 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Benchmark/CRPG_CameraNetBenchmarkCommandlet.h"
+
+// CRPG
+#include "Benchmark/CRPG_CameraNetBenchmarkSubsystem.h"
+
+// UE
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace CameraNetBenchmark
+{
+	// Time the server gets to load the map before clients connect, and clients get to join before measuring.
+	constexpr float ServerStartupTime = 10.f;
+	constexpr double ClientJoinTime = 20.0;
+
+	// Extra time after the expected end before remaining processes are killed.
+	constexpr double ProcessTimeout = 60.0;
+}
+
+UCRPG_CameraNetBenchmarkCommandlet::UCRPG_CameraNetBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	Duration = 30.0;
+	Port = 17777;
+	MaxActorsConsidered = 0;
+}
+
+int32 UCRPG_CameraNetBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamValues;
+	ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+	Map = ParamValues.FindRef(TEXT("Map"));
+	if(Map.IsEmpty())
+	{
+		UE_LOG(LogCRPGCameraNetBenchmark, Error, TEXT("-Map= is required."));
+		return 1;
+	}
+
+	if(const FString* DurationValue = ParamValues.Find(TEXT("Duration")))
+	{
+		Duration = FMath::Max(FCString::Atod(**DurationValue), 1.0);
+	}
+
+	if(const FString* PortValue = ParamValues.Find(TEXT("Port")))
+	{
+		Port = FCString::Atoi(**PortValue);
+	}
+
+	if(const FString* MaxActorsConsideredValue = ParamValues.Find(TEXT("MaxActorsConsidered")))
+	{
+		MaxActorsConsidered = FMath::Max(FCString::Atoi(**MaxActorsConsideredValue), 0);
+	}
+
+	OutputDirectory = ParamValues.Contains(TEXT("Output"))
+		? ParamValues[TEXT("Output")]
+		: FPaths::ProjectSavedDir() / TEXT("CameraNetBenchmark") / FDateTime::Now().ToString();
+	OutputDirectory = FPaths::ConvertRelativePathToFull(OutputDirectory);
+
+	// Every net driver reads these from its command line.
+	NetworkEmulationArgs.Reset();
+	for (const TCHAR* Setting : {TEXT("PktLag"), TEXT("PktLagVariance"), TEXT("PktLoss")})
+	{
+		if(const FString* Value = ParamValues.Find(Setting))
+		{
+			NetworkEmulationArgs += FString::Printf(TEXT(" -%s=%s"), Setting, **Value);
+		}
+	}
+
+	TArray<FString> ClientCounts;
+	const FString ClientsValue = ParamValues.Contains(TEXT("Clients")) ? ParamValues[TEXT("Clients")] : TEXT("1,4,8");
+	ClientsValue.ParseIntoArray(ClientCounts, TEXT(","));
+
+	TArray<TSharedPtr<FJsonValue>> Rounds;
+	bool bSuccess = true;
+
+	for (const FString& ClientCount : ClientCounts)
+	{
+		const int32 NumClients = FCString::Atoi(*ClientCount);
+		if(NumClients <= 0)
+		{
+			continue;
+		}
+
+		if(const TSharedPtr<FJsonObject> Round = RunRound(NumClients))
+		{
+			Rounds.Add(MakeShared<FJsonValueObject>(Round));
+
+			const int32 RoundActorsConsidered = static_cast<int32>(Round->GetNumberField(TEXT("maxActorsConsideredPerConnection")));
+			if(MaxActorsConsidered > 0 && RoundActorsConsidered > MaxActorsConsidered)
+			{
+				UE_LOG(LogCRPGCameraNetBenchmark, Error, TEXT("%d client(s): the server considered %d actors for a connection, more than %d."),
+					NumClients, RoundActorsConsidered, MaxActorsConsidered);
+				bSuccess = false;
+			}
+		}
+		else
+		{
+			bSuccess = false;
+		}
+	}
+
+	const TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+	Summary->SetStringField(TEXT("map"), Map);
+	Summary->SetNumberField(TEXT("duration"), Duration);
+	Summary->SetStringField(TEXT("networkEmulation"), NetworkEmulationArgs.TrimStart());
+	Summary->SetArrayField(TEXT("rounds"), Rounds);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Summary, Writer);
+
+	const FString SummaryPath = OutputDirectory / TEXT("summary.json");
+	if(!FFileHelper::SaveStringToFile(Json, *SummaryPath))
+	{
+		UE_LOG(LogCRPGCameraNetBenchmark, Error, TEXT("Failed to write %s."), *SummaryPath);
+		return 1;
+	}
+
+	UE_LOG(LogCRPGCameraNetBenchmark, Display, TEXT("Wrote %s."), *SummaryPath);
+	return bSuccess ? 0 : 1;
+}
+
+TSharedPtr<FJsonObject> UCRPG_CameraNetBenchmarkCommandlet::RunRound(int32 NumClients) const
+{
+	const FString RoundDirectory = OutputDirectory / FString::Printf(TEXT("Clients_%d"), NumClients);
+	IFileManager::Get().MakeDirectory(*RoundDirectory, true);
+
+	const FString Executable = FPlatformProcess::ExecutablePath();
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString CommonArgs = FString::Printf(TEXT("\"%s\" -nullrhi -nosound -nosplash -unattended -CameraNetBench%s"), *ProjectPath, *NetworkEmulationArgs);
+
+	UE_LOG(LogCRPGCameraNetBenchmark, Display, TEXT("Running %d client(s) for %.0f seconds."), NumClients, Duration);
+
+	TArray<FProcHandle> Processes;
+
+	// The server measures from map load, so it runs for the clients' join time as well.
+	const FString ServerOutput = RoundDirectory / TEXT("server.json");
+	const FString ServerArgs = FString::Printf(TEXT("%s %s -server -Port=%d -CameraNetBenchDuration=%f -CameraNetBenchOutput=\"%s\""),
+		*CommonArgs, *Map, Port, Duration + CameraNetBenchmark::ClientJoinTime, *ServerOutput);
+	Processes.Add(FPlatformProcess::CreateProc(*Executable, *ServerArgs, false, true, true, nullptr, 0, nullptr, nullptr));
+
+	FPlatformProcess::Sleep(CameraNetBenchmark::ServerStartupTime);
+
+	TArray<FString> ClientOutputs;
+	for (int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+	{
+		const FString& ClientOutput = ClientOutputs.Add_GetRef(RoundDirectory / FString::Printf(TEXT("client_%d.json"), ClientIndex));
+		const FString ClientArgs = FString::Printf(TEXT("%s 127.0.0.1:%d -game -CameraNetBenchClient=%d -CameraNetBenchDuration=%f -CameraNetBenchOutput=\"%s\""),
+			*CommonArgs, Port, ClientIndex, Duration, *ClientOutput);
+		Processes.Add(FPlatformProcess::CreateProc(*Executable, *ClientArgs, false, true, true, nullptr, 0, nullptr, nullptr));
+	}
+
+	const double Deadline = FPlatformTime::Seconds() + Duration + CameraNetBenchmark::ClientJoinTime + CameraNetBenchmark::ProcessTimeout;
+	for (FProcHandle& Process : Processes)
+	{
+		while(Process.IsValid() && FPlatformProcess::IsProcRunning(Process))
+		{
+			if(FPlatformTime::Seconds() > Deadline)
+			{
+				UE_LOG(LogCRPGCameraNetBenchmark, Warning, TEXT("Process did not exit in time, terminating it."));
+				FPlatformProcess::TerminateProc(Process, true);
+				break;
+			}
+
+			FPlatformProcess::Sleep(0.5f);
+		}
+
+		FPlatformProcess::CloseProc(Process);
+	}
+
+	const TSharedPtr<FJsonObject> ServerResults = LoadResults(ServerOutput);
+	if(!ServerResults)
+	{
+		return nullptr;
+	}
+
+	const TSharedRef<FJsonObject> Round = MakeShared<FJsonObject>();
+	Round->SetNumberField(TEXT("clients"), NumClients);
+
+	// Server frame time and actors considered per connection once every client has joined.
+	double FrameTimeSum = 0.0;
+	int32 NumFrameTimeSamples = 0;
+	int32 MaxActorsConsideredPerConnection = INDEX_NONE;
+	for (const TSharedPtr<FJsonValue>& SampleValue : ServerResults->GetArrayField(TEXT("samples")))
+	{
+		const TSharedPtr<FJsonObject>& Sample = SampleValue->AsObject();
+		if(Sample->GetNumberField(TEXT("players")) >= NumClients)
+		{
+			FrameTimeSum += Sample->GetNumberField(TEXT("frameTimeMs"));
+			++NumFrameTimeSamples;
+
+			double SampleActorsConsidered = INDEX_NONE;
+			if(Sample->TryGetNumberField(TEXT("maxActorsConsideredPerConnection"), SampleActorsConsidered))
+			{
+				MaxActorsConsideredPerConnection = FMath::Max(MaxActorsConsideredPerConnection, static_cast<int32>(SampleActorsConsidered));
+			}
+		}
+	}
+	Round->SetNumberField(TEXT("serverFrameTimeMs"), NumFrameTimeSamples > 0 ? FrameTimeSum / NumFrameTimeSamples : -1.0);
+	Round->SetNumberField(TEXT("maxActorsConsideredPerConnection"), MaxActorsConsideredPerConnection);
+
+	int32 TotalCorrections = 0;
+	int32 MaxMoveHistoryHighWaterMark = 0;
+	TArray<TSharedPtr<FJsonValue>> ClientResultValues;
+	bool bAllClientsReported = true;
+
+	for (const FString& ClientOutput : ClientOutputs)
+	{
+		const TSharedPtr<FJsonObject> ClientResults = LoadResults(ClientOutput);
+		if(!ClientResults)
+		{
+			bAllClientsReported = false;
+			continue;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>& Samples = ClientResults->GetArrayField(TEXT("samples"));
+		if(Samples.Num() > 0)
+		{
+			const TSharedPtr<FJsonObject>& LastSample = Samples.Last()->AsObject();
+			TotalCorrections += static_cast<int32>(LastSample->GetNumberField(TEXT("corrections")));
+			MaxMoveHistoryHighWaterMark = FMath::Max(MaxMoveHistoryHighWaterMark, static_cast<int32>(LastSample->GetNumberField(TEXT("moveHistoryHighWaterMark"))));
+		}
+
+		ClientResultValues.Add(MakeShared<FJsonValueObject>(ClientResults));
+	}
+
+	Round->SetNumberField(TEXT("corrections"), TotalCorrections);
+	Round->SetNumberField(TEXT("maxMoveHistoryHighWaterMark"), MaxMoveHistoryHighWaterMark);
+	Round->SetObjectField(TEXT("server"), ServerResults);
+	Round->SetArrayField(TEXT("clientResults"), ClientResultValues);
+
+	UE_LOG(LogCRPGCameraNetBenchmark, Display, TEXT("%d client(s): server frame %.2f ms, %d corrections, move history high-water %d, at most %d actors considered per connection."),
+		NumClients, Round->GetNumberField(TEXT("serverFrameTimeMs")), TotalCorrections, MaxMoveHistoryHighWaterMark, MaxActorsConsideredPerConnection);
+
+	return bAllClientsReported ? Round.ToSharedPtr() : nullptr;
+}
+
+TSharedPtr<FJsonObject> UCRPG_CameraNetBenchmarkCommandlet::LoadResults(const FString& Path)
+{
+	FString Json;
+	if(!FFileHelper::LoadFileToString(Json, *Path))
+	{
+		UE_LOG(LogCRPGCameraNetBenchmark, Error, TEXT("Missing results %s."), *Path);
+		return nullptr;
+	}
+
+	TSharedPtr<FJsonObject> Results;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if(!FJsonSerializer::Deserialize(Reader, Results) || !Results.IsValid())
+	{
+		UE_LOG(LogCRPGCameraNetBenchmark, Error, TEXT("Could not parse results %s."), *Path);
+		return nullptr;
+	}
+
+	return Results;
+}
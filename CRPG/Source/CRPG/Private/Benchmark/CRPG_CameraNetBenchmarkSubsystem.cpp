@@ -0,0 +1,269 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Benchmark/CRPG_CameraNetBenchmarkSubsystem.h"
+
+// CRPG
+#include "Game/CRPG_ReplicationGraph.h"
+#include "Player/CRPG_PlayerCamera.h"
+#include "Player/CRPG_PlayerController.h"
+
+// UE
+#include "Dom/JsonObject.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "EngineUtils.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY(LogCRPGCameraNetBenchmark);
+
+namespace CameraNetBenchmark
+{
+	// Seconds of free camera input before the camera locks to the pawn for the rest of the cycle.
+	constexpr double FreeInputTime = 7.0;
+	constexpr double CycleTime = 10.0;
+
+	// ActorsConsidered is left out when it's INDEX_NONE, as for a client's connection to the server.
+	TSharedPtr<FJsonValue> MakeConnectionValue(const UNetConnection* Connection, int32 ActorsConsidered)
+	{
+		TSharedPtr<FJsonObject> ConnectionObject = MakeShared<FJsonObject>();
+		ConnectionObject->SetStringField(TEXT("address"), Connection->LowLevelGetRemoteAddress(true));
+		ConnectionObject->SetNumberField(TEXT("outBytesPerSecond"), Connection->OutBytesPerSecond);
+		ConnectionObject->SetNumberField(TEXT("inBytesPerSecond"), Connection->InBytesPerSecond);
+		ConnectionObject->SetNumberField(TEXT("outLossPercentage"), Connection->GetOutLossPercentage().GetAvgLossPercentage());
+		ConnectionObject->SetNumberField(TEXT("pingMs"), Connection->AvgLag * 1000.0);
+		if(ActorsConsidered != INDEX_NONE)
+		{
+			ConnectionObject->SetNumberField(TEXT("actorsConsidered"), ActorsConsidered);
+		}
+		return MakeShared<FJsonValueObject>(ConnectionObject);
+	}
+}
+
+bool UCRPG_CameraNetBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("CameraNetBench")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCRPG_CameraNetBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Duration = 30.0;
+	FParse::Value(FCommandLine::Get(), TEXT("CameraNetBenchDuration="), Duration);
+
+	OutputPath = FPaths::ProjectSavedDir() / TEXT("CameraNetBenchmark.json");
+	FParse::Value(FCommandLine::Get(), TEXT("CameraNetBenchOutput="), OutputPath);
+
+	ClientIndex = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("CameraNetBenchClient="), ClientIndex);
+
+	ElapsedTime = 0.0;
+	SampleElapsedTime = 0.0;
+	NumSampledFrames = 0;
+	SampledFrameTime = 0.0;
+	MaxSampledFrameTime = 0.0;
+	LastInputRpcs = 0;
+	LastAcks = 0;
+	LastCorrections = 0;
+	LastZoomSnapshots = 0;
+	bFinished = false;
+}
+
+bool UCRPG_CameraNetBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game;
+}
+
+void UCRPG_CameraNetBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Clients start measuring once they have joined the server's map.
+	if(bFinished || GetWorld()->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	if(!IsServer())
+	{
+		TickScriptedInput(DeltaTime);
+	}
+
+	// Work time only, a server waiting for its max tick rate is idle rather than busy.
+	const double FrameTime = FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0);
+	++NumSampledFrames;
+	SampledFrameTime += FrameTime;
+	MaxSampledFrameTime = FMath::Max(MaxSampledFrameTime, FrameTime);
+
+	ElapsedTime += DeltaTime;
+	SampleElapsedTime += DeltaTime;
+
+	if(SampleElapsedTime >= 1.0)
+	{
+		TakeSample();
+	}
+
+	if(ElapsedTime >= Duration)
+	{
+		WriteResults();
+		bFinished = true;
+
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+TStatId UCRPG_CameraNetBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCRPG_CameraNetBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+bool UCRPG_CameraNetBenchmarkSubsystem::IsServer() const
+{
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	return NetMode == NM_DedicatedServer || NetMode == NM_ListenServer;
+}
+
+void UCRPG_CameraNetBenchmarkSubsystem::TickScriptedInput(float DeltaTime)
+{
+	ACRPG_PlayerController* PlayerController = Cast<ACRPG_PlayerController>(GetWorld()->GetFirstPlayerController());
+	if(!IsValid(PlayerController))
+	{
+		return;
+	}
+
+	ACRPG_PlayerCamera* PlayerCamera = PlayerController->GetPlayerCamera();
+	if(!IsValid(PlayerCamera))
+	{
+		return;
+	}
+
+	const double Time = ElapsedTime + ClientIndex * 0.37;
+	const float Zoom = FMath::Sin(Time * 0.7) * 0.5f;
+
+	if(FMath::Fmod(Time, CameraNetBenchmark::CycleTime) >= CameraNetBenchmark::FreeInputTime)
+	{
+		if(!PlayerController->IsLockedToTarget() && IsValid(PlayerController->GetPawn()))
+		{
+			PlayerController->LockCameraToTarget(PlayerController->GetPawn());
+		}
+
+		PlayerCamera->ZoomCamera(Zoom);
+		return;
+	}
+
+	// Moving breaks the lock, the same as player input does.
+	if(PlayerController->IsLockedToTarget())
+	{
+		PlayerController->UnlockCamera();
+	}
+
+	PlayerCamera->MoveCamera(FVector2D(FMath::Cos(Time * 0.8), FMath::Sin(Time * 0.8)));
+	PlayerCamera->RotateCamera(FMath::Sin(Time * 0.5));
+	PlayerCamera->ZoomCamera(Zoom);
+}
+
+void UCRPG_CameraNetBenchmarkSubsystem::TakeSample()
+{
+	const bool bServer = IsServer();
+
+	// Camera counters of every camera in this process, only the owned or authoritative ones count anything.
+	FCameraNetCounters Totals;
+	int32 MoveHistoryHighWaterMark = 0;
+	uint32 MoveHistoryOverflows = 0;
+
+	for (TActorIterator<ACRPG_PlayerCamera> It(GetWorld()); It; ++It)
+	{
+		const FCameraNetCounters& Counters = It->GetNetCounters();
+		Totals.InputRpcsSent += Counters.InputRpcsSent;
+		Totals.CorrectionsReceived += Counters.CorrectionsReceived;
+		Totals.ZoomSnapshotsSent += Counters.ZoomSnapshotsSent;
+		Totals.InputRpcsReceived += Counters.InputRpcsReceived;
+		Totals.AcksSent += Counters.AcksSent;
+		Totals.CorrectionsSent += Counters.CorrectionsSent;
+
+		MoveHistoryHighWaterMark = FMath::Max(MoveHistoryHighWaterMark, It->GetMoveHistoryHighWaterMark());
+		MoveHistoryOverflows += It->GetMoveHistoryOverflowCount();
+	}
+
+	const uint32 InputRpcs = bServer ? Totals.InputRpcsReceived : Totals.InputRpcsSent;
+	const uint32 Corrections = bServer ? Totals.CorrectionsSent : Totals.CorrectionsReceived;
+
+	TSharedPtr<FJsonObject> Sample = MakeShared<FJsonObject>();
+	Sample->SetNumberField(TEXT("time"), ElapsedTime);
+	Sample->SetNumberField(TEXT("players"), GetWorld()->GetNumPlayerControllers());
+	Sample->SetNumberField(TEXT("frameTimeMs"), NumSampledFrames > 0 ? SampledFrameTime * 1000.0 / NumSampledFrames : 0.0);
+	Sample->SetNumberField(TEXT("maxFrameTimeMs"), MaxSampledFrameTime * 1000.0);
+	Sample->SetNumberField(TEXT("inputRpcsPerSecond"), (InputRpcs - LastInputRpcs) / SampleElapsedTime);
+	Sample->SetNumberField(TEXT("acksPerSecond"), (Totals.AcksSent - LastAcks) / SampleElapsedTime);
+	Sample->SetNumberField(TEXT("correctionsPerSecond"), (Corrections - LastCorrections) / SampleElapsedTime);
+	Sample->SetNumberField(TEXT("zoomSnapshotsPerSecond"), (Totals.ZoomSnapshotsSent - LastZoomSnapshots) / SampleElapsedTime);
+	Sample->SetNumberField(TEXT("corrections"), Corrections);
+	Sample->SetNumberField(TEXT("moveHistoryHighWaterMark"), MoveHistoryHighWaterMark);
+	Sample->SetNumberField(TEXT("moveHistoryOverflows"), MoveHistoryOverflows);
+
+	TArray<TSharedPtr<FJsonValue>> Connections;
+	int32 MaxActorsConsidered = INDEX_NONE;
+	if(const UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+	{
+		if(NetDriver->ServerConnection)
+		{
+			Connections.Add(CameraNetBenchmark::MakeConnectionValue(NetDriver->ServerConnection, INDEX_NONE));
+		}
+
+		// Only known with the CRPG replication graph, which is what the count is checked against.
+		UCRPG_ReplicationGraph* ReplicationGraph = Cast<UCRPG_ReplicationGraph>(NetDriver->GetReplicationDriver());
+		
+		for (UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			const int32 ActorsConsidered = ReplicationGraph ? ReplicationGraph->CountActorsConsideredForConnection(Connection) : INDEX_NONE;
+			MaxActorsConsidered = FMath::Max(MaxActorsConsidered, ActorsConsidered);
+			
+			Connections.Add(CameraNetBenchmark::MakeConnectionValue(Connection, ActorsConsidered));
+		}
+	}
+	Sample->SetArrayField(TEXT("connections"), Connections);
+	Sample->SetNumberField(TEXT("maxActorsConsideredPerConnection"), MaxActorsConsidered);
+
+	Samples.Add(Sample);
+
+	LastInputRpcs = InputRpcs;
+	LastAcks = Totals.AcksSent;
+	LastCorrections = Corrections;
+	LastZoomSnapshots = Totals.ZoomSnapshotsSent;
+
+	SampleElapsedTime = 0.0;
+	NumSampledFrames = 0;
+	SampledFrameTime = 0.0;
+	MaxSampledFrameTime = 0.0;
+}
+
+void UCRPG_CameraNetBenchmarkSubsystem::WriteResults()
+{
+	TArray<TSharedPtr<FJsonValue>> SampleValues;
+	for (const TSharedPtr<FJsonObject>& Sample : Samples)
+	{
+		SampleValues.Add(MakeShared<FJsonValueObject>(Sample));
+	}
+
+	const TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	Results->SetStringField(TEXT("role"), IsServer() ? TEXT("server") : TEXT("client"));
+	Results->SetNumberField(TEXT("clientIndex"), ClientIndex);
+	Results->SetNumberField(TEXT("duration"), ElapsedTime);
+	Results->SetArrayField(TEXT("samples"), SampleValues);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Results, Writer);
+
+	if(FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogCRPGCameraNetBenchmark, Display, TEXT("Wrote %d samples to %s."), Samples.Num(), *OutputPath);
+	}
+	else
+	{
+		UE_LOG(LogCRPGCameraNetBenchmark, Error, TEXT("Failed to write results to %s."), *OutputPath);
+	}
+}
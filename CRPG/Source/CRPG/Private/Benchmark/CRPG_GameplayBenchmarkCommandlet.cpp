@@ -0,0 +1,292 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Benchmark/CRPG_GameplayBenchmarkCommandlet.h"
+
+// CRPG
+#include "Benchmark/CRPG_BenchmarkCharacter.h"
+#include "Benchmark/CRPG_BenchmarkReport.h"
+#include "Characters/CRPG_CharacterTickState.h"
+#include "Game/CRPG_CharacterTickSubsystem.h"
+#include "Player/Camera/CRPG_CameraFraming.h"
+#include "Player/Selection/CRPG_SelectionFrustum.h"
+
+// UE
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCRPGGameplayBenchmark, Log, All);
+
+namespace GameplayBenchmark
+{
+	// Group sizes from a single character up to a large battle, to show how group framing scales.
+	constexpr int32 GroupSizes[] = {1, 8, 32, 128, 512};
+
+	// Selectable unit counts from a party up to a very large battle, to show how marquee culling scales.
+	constexpr int32 UnitCounts[] = {100, 1000, 10000};
+
+	// A large encounter, and a cast well past UCRPG_CharacterTickSubsystem::MinParallelCharacters.
+	constexpr int32 TickedCharacterCounts[] = {500, 20000};
+
+	// Characters in the world tick runs.
+	constexpr int32 NumWorldCharacters = 500;
+
+	constexpr float TickDeltaTime = 1.f / 60.f;
+
+	// How the characters in a world tick run advance their gameplay state.
+	enum class ECharacterTickMode : uint8
+	{
+		Idle,
+		PerActor,
+		Batched
+	};
+
+	const TCHAR* LexToString(ECharacterTickMode Mode)
+	{
+		switch (Mode)
+		{
+		case ECharacterTickMode::PerActor:
+			return TEXT("PerActor");
+			
+		case ECharacterTickMode::Batched:
+			return TEXT("Batched");
+			
+		default:
+			return TEXT("Idle");
+		}
+	}
+
+	// Timers long enough that no character runs out during the run, so every frame does the same work.
+	struct FGameplayTimers
+	{
+		float ActionCooldown;
+		float StatusTime;
+		float StatusDamageRate;
+	};
+
+	FGameplayTimers MakeTimers(FRandomStream& Random)
+	{
+		return {Random.FRandRange(1e5f, 2e5f), Random.FRandRange(1e5f, 2e5f), Random.FRandRange(1.f, 5.f)};
+	}
+}
+
+UCRPG_GameplayBenchmarkCommandlet::UCRPG_GameplayBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCRPG_GameplayBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamValues;
+	ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+	const int64 Iterations = ParamValues.Contains(TEXT("Iterations")) ? FMath::Max<int64>(FCString::Atoi64(*ParamValues[TEXT("Iterations")]), 1) : 5000000;
+	const int32 Frames = ParamValues.Contains(TEXT("Frames")) ? FMath::Max(FCString::Atoi(*ParamValues[TEXT("Frames")]), 1) : 600;
+	const FBenchmarkReportSettings Settings = BenchmarkReport::ParseSettings(ParamValues, Switches, TEXT("Gameplay"));
+
+	TMap<FString, double> Results = RunKernels(Iterations);
+	Results.Append(RunWorldTicks(Frames));
+
+	return BenchmarkReport::Report(Settings, Results, Iterations);
+}
+
+TMap<FString, double> UCRPG_GameplayBenchmarkCommandlet::RunKernels(int64 Iterations) const
+{
+	using namespace GameplayBenchmark;
+	using BenchmarkReport::Time;
+
+	FRandomStream Random(1337);
+	
+	double Sink = 0.0;
+	TMap<FString, double> Results;
+
+	// Members scattered over a battlefield, relative to the camera as TickFollowGroup gathers them.
+	TArray<FVector4f> GroupPositions;
+	for (int32 Index = 0; Index < GroupSizes[UE_ARRAY_COUNT(GroupSizes) - 1]; ++Index)
+	{
+		GroupPositions.Emplace(Random.FRandRange(-5000.f, 5000.f), Random.FRandRange(-5000.f, 5000.f), Random.FRandRange(-200.f, 200.f), 0.f);
+	}
+
+	for (const int32 GroupSize : GroupSizes)
+	{
+		// Fewer iterations for larger groups so every size runs for a similar time.
+		const int64 GroupIterations = FMath::Max<int64>(Iterations / GroupSize, 1);
+		const TConstArrayView<FVector4f> Group(GroupPositions.GetData(), GroupSize);
+		
+		Results.Add(FString::Printf(TEXT("GroupBounds%d"), GroupSize), Time(GroupIterations, Sink, [&](int64)
+		{
+			return CameraFraming::ComputeBounds(Group).Centroid.X;
+		}));
+		
+		Results.Add(FString::Printf(TEXT("GroupBoundsScalar%d"), GroupSize), Time(GroupIterations, Sink, [&](int64)
+		{
+			return CameraFraming::ComputeBoundsScalar(Group).Centroid.X;
+		}));
+	}
+
+	// Units spread over a battlefield, seen by a camera high above through a marquee over part of it.
+	const int32 MaxUnits = UnitCounts[UE_ARRAY_COUNT(UnitCounts) - 1];
+	TArray<float> UnitX;
+	TArray<float> UnitY;
+	TArray<float> UnitZ;
+	TArray<float> UnitRadius;
+	for (int32 Index = 0; Index < MaxUnits; ++Index)
+	{
+		UnitX.Add(Random.FRandRange(-10000.f, 10000.f));
+		UnitY.Add(Random.FRandRange(-10000.f, 10000.f));
+		UnitZ.Add(Random.FRandRange(0.f, 200.f));
+		UnitRadius.Add(Random.FRandRange(40.f, 120.f));
+	}
+
+	const FVector MarqueeEye(0.f, 0.f, 4000.f);
+	const FVector MarqueeOrigins[4] = {MarqueeEye, MarqueeEye, MarqueeEye, MarqueeEye};
+	const FVector MarqueeDirections[4] =
+	{
+		FVector(-3000.f, -2000.f, 0.f) - MarqueeEye,
+		FVector(3000.f, -2000.f, 0.f) - MarqueeEye,
+		FVector(3000.f, 2000.f, 0.f) - MarqueeEye,
+		FVector(-3000.f, 2000.f, 0.f) - MarqueeEye
+	};
+	const FSelectionFrustum MarqueeFrustum = FSelectionFrustum::FromCornerRays(MarqueeOrigins, MarqueeDirections);
+
+	TArray<int32> MarqueeIndices;
+	MarqueeIndices.Reserve(MaxUnits);
+
+	for (const int32 UnitCount : UnitCounts)
+	{
+		const int64 UnitIterations = FMath::Max<int64>(Iterations / UnitCount, 1);
+
+		FSelectionBounds Bounds;
+		Bounds.X = UnitX.GetData();
+		Bounds.Y = UnitY.GetData();
+		Bounds.Z = UnitZ.GetData();
+		Bounds.Radius = UnitRadius.GetData();
+		Bounds.Num = UnitCount;
+
+		Results.Add(FString::Printf(TEXT("MarqueeCull%d"), UnitCount), Time(UnitIterations, Sink, [&](int64)
+		{
+			MarqueeIndices.Reset();
+			SelectionFrustum::CullSpheres(MarqueeFrustum, Bounds, MarqueeIndices);
+			return static_cast<double>(MarqueeIndices.Num());
+		}));
+
+		Results.Add(FString::Printf(TEXT("MarqueeCullScalar%d"), UnitCount), Time(UnitIterations, Sink, [&](int64)
+		{
+			MarqueeIndices.Reset();
+			SelectionFrustum::CullSpheresScalar(MarqueeFrustum, Bounds, MarqueeIndices);
+			return static_cast<double>(MarqueeIndices.Num());
+		}));
+	}
+
+	for (const int32 NumCharacters : TickedCharacterCounts)
+	{
+		FCharacterTickState CharacterState;
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			const FGameplayTimers Timers = MakeTimers(Random);
+			
+			CharacterState.Add();
+			CharacterState.ActionCooldowns[Index] = Timers.ActionCooldown;
+			CharacterState.StatusTimes[Index] = Timers.StatusTime;
+			CharacterState.StatusDamageRates[Index] = Timers.StatusDamageRate;
+		}
+
+		const int64 CharacterIterations = FMath::Max<int64>(Iterations / NumCharacters, 1);
+
+		Results.Add(FString::Printf(TEXT("CharacterTickSerial%d"), NumCharacters), Time(CharacterIterations, Sink, [&](int64)
+		{
+			CharacterTick::Update(CharacterState, TickDeltaTime, 0, CharacterState.Num());
+			return CharacterState.PendingDamage[0];
+		}));
+
+		Results.Add(FString::Printf(TEXT("CharacterTickParallel%d"), NumCharacters), Time(CharacterIterations, Sink, [&](int64)
+		{
+			CharacterTick::UpdateParallel(CharacterState, TickDeltaTime, UCRPG_CharacterTickSubsystem::ChunkSize);
+			return CharacterState.PendingDamage[0];
+		}));
+	}
+
+	UE_LOG(LogCRPGGameplayBenchmark, Verbose, TEXT("Checksum %f"), Sink);
+	return Results;
+}
+
+TMap<FString, double> UCRPG_GameplayBenchmarkCommandlet::RunWorldTicks(int32 Frames) const
+{
+	using namespace GameplayBenchmark;
+	using BenchmarkReport::Time;
+
+	double Sink = 0.0;
+	TMap<FString, double> Results;
+
+	for (const ECharacterTickMode Mode : {ECharacterTickMode::Idle, ECharacterTickMode::PerActor, ECharacterTickMode::Batched})
+	{
+		// A fresh world per mode, so no run inherits another's actors or allocations.
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CRPGGameplayBenchmark"));
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+
+		// There is no game mode to start play, begin it directly so spawned characters run BeginPlay.
+		World->GetWorldSettings()->NotifyBeginPlay();
+
+		UCRPG_CharacterTickSubsystem* CharacterTickSubsystem = World->GetSubsystem<UCRPG_CharacterTickSubsystem>();
+		
+		// The same timers in every mode.
+		FRandomStream Random(1337);
+		const int32 GridSize = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumWorldCharacters)));
+		
+		for (int32 Index = 0; Index < NumWorldCharacters; ++Index)
+		{
+			const FVector Location((Index % GridSize) * 200.f, (Index / GridSize) * 200.f, 100.f);
+			ACRPG_BenchmarkCharacter* Character = World->SpawnActor<ACRPG_BenchmarkCharacter>(Location, FRotator::ZeroRotator);
+			if(!Character)
+			{
+				continue;
+			}
+			
+			const FGameplayTimers Timers = MakeTimers(Random);
+
+			// Characters register with the subsystem in BeginPlay. Only the batched run keeps them there.
+			if(Mode == ECharacterTickMode::Batched && CharacterTickSubsystem)
+			{
+				CharacterTickSubsystem->StartActionCooldown(Character, Timers.ActionCooldown);
+				CharacterTickSubsystem->ApplyStatusEffect(Character, Timers.StatusTime, Timers.StatusDamageRate);
+				continue;
+			}
+
+			if(CharacterTickSubsystem)
+			{
+				CharacterTickSubsystem->Unregister(Character);
+			}
+
+			if(Mode == ECharacterTickMode::PerActor)
+			{
+				Character->SetGameplayState(Timers.ActionCooldown, Timers.StatusTime, Timers.StatusDamageRate);
+				Character->SetActorTickEnabled(true);
+			}
+		}
+
+		Results.Add(FString::Printf(TEXT("CharacterWorldTick%s%d"), LexToString(Mode), NumWorldCharacters), Time(Frames, Sink, [World](int64)
+		{
+			// Tick functions are queued at most once per engine frame.
+			++GFrameCounter;
+			World->Tick(LEVELTICK_All, TickDeltaTime);
+			return static_cast<double>(World->GetTimeSeconds());
+		}));
+
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	UE_LOG(LogCRPGGameplayBenchmark, Verbose, TEXT("Checksum %f"), Sink);
+	return Results;
+}
@@ -0,0 +1,106 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Characters/CRPG_CharacterTickState.h"
+
+// UE
+#include "Async/ParallelFor.h"
+
+int32 FCharacterTickState::Add()
+{
+	ActionCooldowns.Add(0.f);
+	StatusTimes.Add(0.f);
+	StatusDamageRates.Add(0.f);
+	PendingDamage.Add(0.f);
+	return Events.Add(ECharacterTickEvents::None);
+}
+
+void FCharacterTickState::RemoveAtSwap(int32 Index)
+{
+	ActionCooldowns.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	StatusTimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	StatusDamageRates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PendingDamage.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Events.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void FCharacterTickState::Reset()
+{
+	ActionCooldowns.Reset();
+	StatusTimes.Reset();
+	StatusDamageRates.Reset();
+	PendingDamage.Reset();
+	Events.Reset();
+}
+
+void CharacterTick::Update(FCharacterTickState& State, float DeltaTime, int32 Begin, int32 End)
+{
+	float* RESTRICT ActionCooldowns = State.ActionCooldowns.GetData();
+	float* RESTRICT StatusTimes = State.StatusTimes.GetData();
+	float* RESTRICT StatusDamageRates = State.StatusDamageRates.GetData();
+	float* RESTRICT PendingDamage = State.PendingDamage.GetData();
+	ECharacterTickEvents* RESTRICT Events = State.Events.GetData();
+	
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		ECharacterTickEvents IndexEvents = ECharacterTickEvents::None;
+
+		if(ActionCooldowns[Index] > 0.f)
+		{
+			ActionCooldowns[Index] = FMath::Max(ActionCooldowns[Index] - DeltaTime, 0.f);
+			if(ActionCooldowns[Index] == 0.f)
+			{
+				IndexEvents |= ECharacterTickEvents::ActionReady;
+			}
+		}
+
+		if(StatusTimes[Index] > 0.f)
+		{
+			// Only the part of the frame the effect was still active for deals damage.
+			const float ActiveTime = FMath::Min(DeltaTime, StatusTimes[Index]);
+			PendingDamage[Index] += StatusDamageRates[Index] * ActiveTime;
+			StatusTimes[Index] -= ActiveTime;
+			
+			if(StatusTimes[Index] <= 0.f)
+			{
+				StatusTimes[Index] = 0.f;
+				StatusDamageRates[Index] = 0.f;
+				IndexEvents |= ECharacterTickEvents::StatusExpired;
+			}
+		}
+
+		// Damage is applied in whole points, the remainder carries over to the next frame.
+		if(PendingDamage[Index] >= 1.f)
+		{
+			IndexEvents |= ECharacterTickEvents::Damaged;
+		}
+
+		Events[Index] = IndexEvents;
+	}
+}
+
+void CharacterTick::UpdateParallel(FCharacterTickState& State, float DeltaTime, int32 ChunkSize)
+{
+	const int32 NumCharacters = State.Num();
+	ChunkSize = FMath::Max(ChunkSize, 1);
+	
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumCharacters, ChunkSize);
+	if(NumChunks <= 1)
+	{
+		Update(State, DeltaTime, 0, NumCharacters);
+		return;
+	}
+	
+	ParallelFor(TEXT("CRPGCharacterTick"), NumChunks, 1, [&State, DeltaTime, ChunkSize, NumCharacters](int32 Chunk)
+	{
+		const int32 Begin = Chunk * ChunkSize;
+		Update(State, DeltaTime, Begin, FMath::Min(Begin + ChunkSize, NumCharacters));
+	});
+}
+
+float CharacterTick::ConsumeDamage(FCharacterTickState& State, int32 Index)
+{
+	const float Damage = FMath::FloorToFloat(State.PendingDamage[Index]);
+	State.PendingDamage[Index] -= Damage;
+	return Damage;
+}
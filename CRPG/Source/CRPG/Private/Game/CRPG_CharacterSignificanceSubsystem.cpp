@@ -0,0 +1,299 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Game/CRPG_CharacterSignificanceSubsystem.h"
+
+// CRPG
+#include "Characters/CRPG_BaseCharacter.h"
+#include "Player/CRPG_PlayerCamera.h"
+#include "Player/CRPG_PlayerController.h"
+
+// UE
+#include "Algo/Sort.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Misc/App.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_LOG_CATEGORY(LogCRPGSignificance);
+
+// Significance stats. View with "stat CRPGSignificance".
+DECLARE_STATS_GROUP(TEXT("CRPG Significance"), STATGROUP_CRPGSignificance, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Update"), STAT_CRPGSignificance_Update, STATGROUP_CRPGSignificance);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Full Tier"), STAT_CRPGSignificance_Full, STATGROUP_CRPGSignificance);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reduced Tier"), STAT_CRPGSignificance_Reduced, STATGROUP_CRPGSignificance);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Low Tier"), STAT_CRPGSignificance_Low, STATGROUP_CRPGSignificance);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Offscreen Tier"), STAT_CRPGSignificance_Offscreen, STATGROUP_CRPGSignificance);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tier Changes"), STAT_CRPGSignificance_TierChanges, STATGROUP_CRPGSignificance);
+
+// CSV profiler counters for the characters per tier.
+CSV_DEFINE_CATEGORY(CRPGSignificance, true);
+
+static FAutoConsoleCommandWithWorld LogSignificanceTiersCommand(
+	TEXT("CRPG.Significance.LogTiers"),
+	TEXT("Logs how many characters are in each significance tier."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&UCRPG_CharacterSignificanceSubsystem::LogTiers));
+
+namespace CharacterSignificance
+{
+	struct FTierSettings
+	{
+		// Share of CharacterBudget a character in the tier costs.
+		float Cost;
+
+		// Lowest score a character needs for the tier.
+		float MinScore;
+		
+		float MeshTickInterval;
+		float MovementTickInterval;
+	};
+
+	// Costs follow the update rate each tier ticks at relative to full rate, at 60 frames per second.
+	constexpr FTierSettings TierSettings[] =
+	{
+		{1.f, 0.6f, 0.f, 0.f},
+		{0.5f, 0.3f, 1.f / 30.f, 1.f / 30.f},
+		{0.25f, 0.f, 1.f / 15.f, 1.f / 15.f},
+		{0.f, 0.f, 1.f / 10.f, 1.f / 10.f}
+	};
+	static_assert(UE_ARRAY_COUNT(TierSettings) == static_cast<int32>(ECharacterSignificanceTier::Num));
+
+	const TCHAR* GetTierName(ECharacterSignificanceTier Tier)
+	{
+		switch (Tier)
+		{
+		case ECharacterSignificanceTier::Full:		return TEXT("Full");
+		case ECharacterSignificanceTier::Reduced:	return TEXT("Reduced");
+		case ECharacterSignificanceTier::Low:		return TEXT("Low");
+		case ECharacterSignificanceTier::Offscreen:	return TEXT("Offscreen");
+		default:									return TEXT("Unknown");
+		}
+	}
+}
+
+bool UCRPG_CharacterSignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCRPG_CharacterSignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_CRPGSignificance_Update);
+	
+	using namespace CharacterSignificance;
+
+	// Significance is what the local player sees, there is nothing to score without a local camera.
+	const ACRPG_PlayerCamera* PlayerCamera = FindLocalCamera();
+	if(!PlayerCamera)
+	{
+		return;
+	}
+
+	const FVector FocusLocation = PlayerCamera->GetActorLocation();
+	const float ZoomPercent = FMath::Clamp(PlayerCamera->GetZoomPercent(), 0.f, 1.f);
+	const float InvViewRadius = 1.f / FMath::Lerp(NearViewRadius, FarViewRadius, ZoomPercent);
+	const float ZoomDetail = FMath::Lerp(1.f, ZoomedOutDetail, ZoomPercent);
+	const bool bCanRender = FApp::CanEverRender();
+
+	// Backwards, so a swap-remove only moves an entry that was already scored.
+	for (int32 Index = Characters.Num() - 1; Index >= 0; --Index)
+	{
+		const ACRPG_BaseCharacter* Character = Characters[Index].Get();
+		if(!IsValid(Character))
+		{
+			RemoveAt(Index);
+			continue;
+		}
+
+		const USkeletalMeshComponent* Mesh = Character->GetMesh();
+		if(bCanRender && Mesh && !Mesh->WasRecentlyRendered(0.2f))
+		{
+			Scores[Index] = -1.f;
+			continue;
+		}
+
+		const float Distance = static_cast<float>(FVector::Dist2D(Character->GetActorLocation(), FocusLocation));
+		Scores[Index] = FMath::Max(1.f - Distance * InvViewRadius, 0.f) * ZoomDetail;
+	}
+
+	SortedIndices.Reset(Characters.Num());
+	for (int32 Index = 0; Index < Characters.Num(); ++Index)
+	{
+		SortedIndices.Add(Index);
+	}
+	
+	Algo::Sort(SortedIndices, [this](int32 A, int32 B)
+	{
+		return Scores[A] > Scores[B];
+	});
+
+	// The most significant characters claim the budget first, the rest drop tiers until they fit.
+	float RemainingBudget = CharacterBudget;
+	FMemory::Memzero(TierCounts);
+	
+	for (const int32 Index : SortedIndices)
+	{
+		int32 Tier = static_cast<int32>(ECharacterSignificanceTier::Offscreen);
+		if(Scores[Index] >= 0.f)
+		{
+			Tier = static_cast<int32>(ECharacterSignificanceTier::Full);
+			while (Scores[Index] < TierSettings[Tier].MinScore || TierSettings[Tier].Cost > RemainingBudget)
+			{
+				if(Tier == static_cast<int32>(ECharacterSignificanceTier::Low))
+				{
+					break;
+				}
+				
+				++Tier;
+			}
+
+			RemainingBudget -= TierSettings[Tier].Cost;
+		}
+
+		++TierCounts[Tier];
+
+		if(Tiers[Index] != static_cast<ECharacterSignificanceTier>(Tier))
+		{
+			ApplyTier(Index, static_cast<ECharacterSignificanceTier>(Tier));
+			INC_DWORD_STAT(STAT_CRPGSignificance_TierChanges);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_CRPGSignificance_Full, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Full)]);
+	SET_DWORD_STAT(STAT_CRPGSignificance_Reduced, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Reduced)]);
+	SET_DWORD_STAT(STAT_CRPGSignificance_Low, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Low)]);
+	SET_DWORD_STAT(STAT_CRPGSignificance_Offscreen, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Offscreen)]);
+	CSV_CUSTOM_STAT(CRPGSignificance, FullTier, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Full)], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(CRPGSignificance, ReducedTier, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Reduced)], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(CRPGSignificance, LowTier, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Low)], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(CRPGSignificance, OffscreenTier, TierCounts[static_cast<int32>(ECharacterSignificanceTier::Offscreen)], ECsvCustomStatOp::Set);
+}
+
+TStatId UCRPG_CharacterSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCRPG_CharacterSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UCRPG_CharacterSignificanceSubsystem::Register(ACRPG_BaseCharacter* Character)
+{
+	if(!IsValid(Character) || IndicesByCharacter.Contains(Character))
+	{
+		return;
+	}
+
+	FCharacterDefaults CharacterDefaults;
+	if(const USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		CharacterDefaults.MeshTickInterval = Mesh->GetComponentTickInterval();
+		CharacterDefaults.VisibilityBasedAnimTickOption = Mesh->VisibilityBasedAnimTickOption;
+		CharacterDefaults.bEnableUpdateRateOptimizations = Mesh->bEnableUpdateRateOptimizations;
+	}
+	
+	if(const UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+	{
+		CharacterDefaults.MovementTickInterval = Movement->GetComponentTickInterval();
+	}
+
+	// Starts in the full tier, which is what its components are already set up for.
+	IndicesByCharacter.Add(Character, Characters.Num());
+	Characters.Add(Character);
+	CharacterKeys.Add(Character);
+	Scores.Add(0.f);
+	Tiers.Add(ECharacterSignificanceTier::Full);
+	Defaults.Add(CharacterDefaults);
+}
+
+void UCRPG_CharacterSignificanceSubsystem::Unregister(ACRPG_BaseCharacter* Character)
+{
+	if(const int32* Index = IndicesByCharacter.Find(Character))
+	{
+		RemoveAt(*Index);
+	}
+}
+
+void UCRPG_CharacterSignificanceSubsystem::LogTiers(UWorld* World)
+{
+	const UCRPG_CharacterSignificanceSubsystem* Subsystem = World ? World->GetSubsystem<UCRPG_CharacterSignificanceSubsystem>() : nullptr;
+	if(!Subsystem)
+	{
+		return;
+	}
+
+	FString Counts;
+	for (int32 Tier = 0; Tier < static_cast<int32>(ECharacterSignificanceTier::Num); ++Tier)
+	{
+		Counts += FString::Printf(TEXT(" %s=%d"), CharacterSignificance::GetTierName(static_cast<ECharacterSignificanceTier>(Tier)), Subsystem->TierCounts[Tier]);
+	}
+
+	UE_LOG(LogCRPGSignificance, Display, TEXT("%d characters:%s"), Subsystem->Num(), *Counts);
+}
+
+const ACRPG_PlayerCamera* UCRPG_CharacterSignificanceSubsystem::FindLocalCamera() const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const ACRPG_PlayerController* PlayerController = Cast<ACRPG_PlayerController>(It->Get());
+		if(PlayerController && PlayerController->IsLocalController())
+		{
+			return PlayerController->GetPlayerCamera();
+		}
+	}
+
+	return nullptr;
+}
+
+void UCRPG_CharacterSignificanceSubsystem::RemoveAt(int32 Index)
+{
+	IndicesByCharacter.Remove(CharacterKeys[Index]);
+
+	const int32 LastIndex = Characters.Num() - 1;
+	if(Index != LastIndex)
+	{
+		IndicesByCharacter[CharacterKeys[LastIndex]] = Index;
+	}
+
+	Characters.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CharacterKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Scores.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Tiers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Defaults.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UCRPG_CharacterSignificanceSubsystem::ApplyTier(int32 Index, ECharacterSignificanceTier Tier)
+{
+	using namespace CharacterSignificance;
+	
+	Tiers[Index] = Tier;
+
+	ACRPG_BaseCharacter* Character = Characters[Index].Get();
+	if(!Character)
+	{
+		return;
+	}
+	
+	const FCharacterDefaults& CharacterDefaults = Defaults[Index];
+	const FTierSettings& Settings = TierSettings[static_cast<int32>(Tier)];
+	const bool bFull = Tier == ECharacterSignificanceTier::Full;
+
+	if(USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		Mesh->SetComponentTickInterval(bFull ? CharacterDefaults.MeshTickInterval : Settings.MeshTickInterval);
+
+		// Update rate optimizations interpolate the frames a lower tier skips.
+		Mesh->bEnableUpdateRateOptimizations = bFull ? CharacterDefaults.bEnableUpdateRateOptimizations : true;
+
+		// Montages keep ticking off screen so their notifies still fire.
+		Mesh->VisibilityBasedAnimTickOption = Tier == ECharacterSignificanceTier::Offscreen
+			? EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered
+			: CharacterDefaults.VisibilityBasedAnimTickOption;
+	}
+
+	// Skipped movement ticks on authority would change how characters move for everyone, not just how they look here.
+	if(UCharacterMovementComponent* Movement = Character->HasAuthority() ? nullptr : Character->GetCharacterMovement())
+	{
+		Movement->SetComponentTickInterval(bFull ? CharacterDefaults.MovementTickInterval : Settings.MovementTickInterval);
+	}
+}
@@ -0,0 +1,158 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Game/CRPG_CharacterTickSubsystem.h"
+
+// CRPG
+#include "Characters/CRPG_BaseCharacter.h"
+
+// Character tick stats. View with "stat CRPGCharacters".
+DECLARE_STATS_GROUP(TEXT("CRPG Characters"), STATGROUP_CRPGCharacters, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Update"), STAT_CRPGCharacters_Update, STATGROUP_CRPGCharacters);
+DECLARE_CYCLE_STAT(TEXT("Commit"), STAT_CRPGCharacters_Commit, STATGROUP_CRPGCharacters);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters"), STAT_CRPGCharacters_Num, STATGROUP_CRPGCharacters);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Commits"), STAT_CRPGCharacters_Commits, STATGROUP_CRPGCharacters);
+
+void UCRPG_CharacterTickSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SET_DWORD_STAT(STAT_CRPGCharacters_Num, Characters.Num());
+	
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CRPGCharacters_Update);
+		
+		if(State.Num() < MinParallelCharacters)
+		{
+			CharacterTick::Update(State, DeltaTime, 0, State.Num());
+		}
+		else
+		{
+			CharacterTick::UpdateParallel(State, DeltaTime, ChunkSize);
+		}
+	}
+
+	Commit();
+}
+
+TStatId UCRPG_CharacterTickSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCRPG_CharacterTickSubsystem, STATGROUP_Tickables);
+}
+
+void UCRPG_CharacterTickSubsystem::Register(ACRPG_BaseCharacter* Character)
+{
+	if(!IsValid(Character) || IndicesByCharacter.Contains(Character))
+	{
+		return;
+	}
+
+	const int32 Index = State.Add();
+	Characters.Add(Character);
+	CharacterKeys.Add(Character);
+	IndicesByCharacter.Add(Character, Index);
+}
+
+void UCRPG_CharacterTickSubsystem::Unregister(ACRPG_BaseCharacter* Character)
+{
+	if(const int32* Index = IndicesByCharacter.Find(Character))
+	{
+		RemoveAt(*Index);
+	}
+}
+
+void UCRPG_CharacterTickSubsystem::StartActionCooldown(const ACRPG_BaseCharacter* Character, float Seconds)
+{
+	if(const int32* Index = IndicesByCharacter.Find(Character))
+	{
+		State.ActionCooldowns[*Index] = FMath::Max(Seconds, 0.f);
+	}
+}
+
+float UCRPG_CharacterTickSubsystem::GetActionCooldown(const ACRPG_BaseCharacter* Character) const
+{
+	const int32* Index = IndicesByCharacter.Find(Character);
+	return Index ? State.ActionCooldowns[*Index] : 0.f;
+}
+
+void UCRPG_CharacterTickSubsystem::ApplyStatusEffect(const ACRPG_BaseCharacter* Character, float Duration, float DamagePerSecond)
+{
+	if(const int32* Index = IndicesByCharacter.Find(Character))
+	{
+		State.StatusTimes[*Index] = FMath::Max(Duration, 0.f);
+		State.StatusDamageRates[*Index] = DamagePerSecond;
+	}
+}
+
+void UCRPG_CharacterTickSubsystem::RemoveAt(int32 Index)
+{
+	IndicesByCharacter.Remove(CharacterKeys[Index]);
+
+	const int32 LastIndex = Characters.Num() - 1;
+	if(Index != LastIndex)
+	{
+		IndicesByCharacter[CharacterKeys[LastIndex]] = Index;
+	}
+
+	Characters.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CharacterKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	State.RemoveAtSwap(Index);
+}
+
+void UCRPG_CharacterTickSubsystem::Commit()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCharacters_Commit);
+
+	Commits.Reset();
+
+	// Backwards, so a swap-remove only moves an entry that was already visited.
+	for (int32 Index = Characters.Num() - 1; Index >= 0; --Index)
+	{
+		if(!Characters[Index].IsValid())
+		{
+			RemoveAt(Index);
+			continue;
+		}
+		
+		if(State.Events[Index] == ECharacterTickEvents::None)
+		{
+			continue;
+		}
+
+		FCommit& CharacterCommit = Commits.AddDefaulted_GetRef();
+		CharacterCommit.Character = Characters[Index];
+		CharacterCommit.Events = State.Events[Index];
+
+		if(EnumHasAnyFlags(State.Events[Index], ECharacterTickEvents::Damaged))
+		{
+			CharacterCommit.Damage = CharacterTick::ConsumeDamage(State, Index);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_CRPGCharacters_Commits, Commits.Num());
+
+	for (const FCommit& CharacterCommit : Commits)
+	{
+		ACRPG_BaseCharacter* Character = CharacterCommit.Character.Get();
+		if(!IsValid(Character))
+		{
+			continue;
+		}
+
+		if(CharacterCommit.Damage > 0.f)
+		{
+			Character->ReceiveStatusEffectDamage(CharacterCommit.Damage);
+		}
+
+		if(EnumHasAnyFlags(CharacterCommit.Events, ECharacterTickEvents::StatusExpired))
+		{
+			Character->OnStatusEffectExpired();
+		}
+
+		if(EnumHasAnyFlags(CharacterCommit.Events, ECharacterTickEvents::ActionReady))
+		{
+			Character->OnActionReady();
+		}
+	}
+}
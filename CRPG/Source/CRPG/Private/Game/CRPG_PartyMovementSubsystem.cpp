@@ -0,0 +1,450 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Game/CRPG_PartyMovementSubsystem.h"
+
+// UE
+#include "AIController.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCRPGPartyMovement, Log, All);
+
+// Party movement stats. View with "stat CRPGPartyMovement".
+DECLARE_STATS_GROUP(TEXT("CRPG Party Movement"), STATGROUP_CRPGPartyMovement, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Request Paths"), STAT_CRPGPartyMovement_RequestPaths, STATGROUP_CRPGPartyMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queries"), STAT_CRPGPartyMovement_PathQueries, STATGROUP_CRPGPartyMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Batch Latency (ms)"), STAT_CRPGPartyMovement_BatchLatency, STATGROUP_CRPGPartyMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Path Cache Hit Rate %"), STAT_CRPGPartyMovement_PathCacheHitRate, STATGROUP_CRPGPartyMovement);
+
+// CSV profiler counters for batch latency and path cache hit rate.
+CSV_DEFINE_CATEGORY(CRPGPartyMovement, true);
+
+UCRPG_PartyMovementSubsystem::UCRPG_PartyMovementSubsystem()
+{
+	NextBatchId = 1;
+	NextOrderId = 1;
+	LastBatchLatency = 0.0;
+}
+
+bool UCRPG_PartyMovementSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return !IsRunningClientOnly() && World && World->GetNetMode() != NM_Client && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCRPG_PartyMovementSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PathCache.Init(PathCacheCapacity, PathCacheCellSize);
+	PathQueryDelegate.BindUObject(this, &UCRPG_PartyMovementSubsystem::OnPathFound);
+}
+
+void UCRPG_PartyMovementSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if(UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UCRPG_PartyMovementSubsystem::OnNavigationGenerationFinished);
+	}
+}
+
+void UCRPG_PartyMovementSubsystem::Deinitialize()
+{
+	if(UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UCRPG_PartyMovementSubsystem::OnNavigationGenerationFinished);
+
+		for (const TPair<uint32, FPendingQuery>& Pair : PendingQueries)
+		{
+			NavSys->AbortAsyncFindPathRequest(Pair.Key);
+		}
+	}
+
+	PendingQueries.Reset();
+	Batches.Reset();
+	OrdersByMember.Reset();
+	PathCache.Reset();
+	
+	Super::Deinitialize();
+}
+
+uint32 UCRPG_PartyMovementSubsystem::RequestPaths(TConstArrayView<FPartyPathRequest> Requests, FOnPartyPathsFound OnFound)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGPartyMovement_RequestPaths);
+	
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if(!NavSys)
+	{
+		return 0;
+	}
+
+	const uint32 BatchId = NextBatchId++;
+	if(NextBatchId == 0)
+	{
+		NextBatchId = 1;
+	}
+	
+	FPathBatch& Batch = Batches.Add(BatchId);
+	Batch.StartTime = FPlatformTime::Seconds();
+	Batch.OnFound = MoveTemp(OnFound);
+	Batch.Results.Reserve(Requests.Num());
+
+	// Members whose starts and goals snap to the same cells share one query.
+	TMap<FPartyPathCacheKey, uint32, TInlineSetAllocator<8>> QueriesByKey;
+	
+	for (const FPartyPathRequest& Request : Requests)
+	{
+		const APawn* Member = Request.Member.Get();
+		if(!IsValid(Member))
+		{
+			continue;
+		}
+
+		const int32 ResultIndex = Batch.Results.AddDefaulted();
+		FPartyPathResult& Result = Batch.Results[ResultIndex];
+		Result.Member = Request.Member;
+		Result.Start = Member->GetNavAgentLocation();
+		Result.Goal = Request.Goal;
+
+		const FNavAgentProperties& AgentProperties = Member->GetNavAgentPropertiesRef();
+		const ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties, Result.Start);
+		if(!NavData)
+		{
+			continue;
+		}
+
+		const FPartyPathCacheKey Key = PathCache.MakeKey(NavData, Result.Start, Result.Goal);
+		if(const uint32* QueryId = QueriesByKey.Find(Key))
+		{
+			PendingQueries[*QueryId].ResultIndices.Add(ResultIndex);
+			continue;
+		}
+		
+		if(PathCache.Find(Key, Result.Start, Result.Goal, Result.Points))
+		{
+			Result.bFromCache = true;
+			continue;
+		}
+
+		const FPathFindingQuery Query(this, *NavData, Result.Start, Result.Goal);
+		const uint32 QueryId = NavSys->FindPathAsync(AgentProperties, Query, PathQueryDelegate);
+		if(QueryId == INVALID_NAVQUERYID)
+		{
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_CRPGPartyMovement_PathQueries);
+
+		FPendingQuery& PendingQuery = PendingQueries.Add(QueryId);
+		PendingQuery.BatchId = BatchId;
+		PendingQuery.Key = Key;
+		PendingQuery.ResultIndices.Add(ResultIndex);
+		
+		QueriesByKey.Add(Key, QueryId);
+		++Batch.NumPending;
+	}
+
+	if(Batch.NumPending == 0)
+	{
+		CompleteBatch(BatchId);
+	}
+
+	return BatchId;
+}
+
+uint32 UCRPG_PartyMovementSubsystem::MoveParty(TConstArrayView<APawn*> Members, const FVector& Destination)
+{
+	TArray<APawn*, TInlineAllocator<8>> Party;
+	FVector Centroid = FVector::ZeroVector;
+	for (APawn* Member : Members)
+	{
+		if(IsValid(Member))
+		{
+			Party.Add(Member);
+			Centroid += Member->GetActorLocation();
+		}
+	}
+
+	if(Party.IsEmpty())
+	{
+		return 0;
+	}
+
+	Centroid /= Party.Num();
+
+	// The front row goes to whoever is closest, so members don't cross each other's paths to their slots.
+	Party.Sort([&Destination](const APawn& A, const APawn& B)
+	{
+		return FVector::DistSquared2D(A.GetActorLocation(), Destination) < FVector::DistSquared2D(B.GetActorLocation(), Destination);
+	});
+	
+	FVector Forward = (Destination - Centroid).GetSafeNormal2D();
+	if(Forward.IsNearlyZero())
+	{
+		Forward = FVector::ForwardVector;
+	}
+	const FVector Right(-Forward.Y, Forward.X, 0.f);
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	
+	TArray<FPartyPathRequest, TInlineAllocator<8>> Requests;
+	for (int32 Index = 0; Index < Party.Num(); ++Index)
+	{
+		const int32 Row = Index / FormationColumns;
+		const int32 Column = Index % FormationColumns;
+		const int32 RowSize = FMath::Min(Party.Num() - Row * FormationColumns, FormationColumns);
+
+		FVector Slot = Destination
+			+ Right * ((Column - (RowSize - 1) * 0.5f) * FormationSpacing)
+			- Forward * (Row * FormationSpacing);
+
+		// Slots off the navmesh, such as behind a wall, are pulled onto it.
+		FNavLocation ProjectedSlot;
+		if(NavSys && NavSys->ProjectPointToNavigation(Slot, ProjectedSlot, FVector(FormationSpacing, FormationSpacing, 250.f), &Party[Index]->GetNavAgentPropertiesRef()))
+		{
+			Slot = ProjectedSlot.Location;
+		}
+
+		FPartyPathRequest& Request = Requests.AddDefaulted_GetRef();
+		Request.Member = Party[Index];
+		Request.Goal = Slot;
+	}
+
+	const uint32 OrderId = NextOrderId++;
+	if(NextOrderId == 0)
+	{
+		NextOrderId = 1;
+	}
+
+	// This order supersedes the members' previous ones, whose paths may still be in flight.
+	TArray<uint32, TInlineAllocator<8>> SupersededBatchIds;
+	for (APawn* Member : Party)
+	{
+		FMemberOrder& Order = OrdersByMember.FindOrAdd(Member);
+		if(Order.BatchId != 0)
+		{
+			SupersededBatchIds.AddUnique(Order.BatchId);
+		}
+		
+		Order.OrderId = OrderId;
+		Order.BatchId = 0;
+	}
+
+	// Members given a newer order by the time the paths arrive are left to it.
+	const uint32 BatchId = RequestPaths(Requests, FOnPartyPathsFound::CreateWeakLambda(this, [this, OrderId](const TArray<FPartyPathResult>& Results)
+	{
+		for (const FPartyPathResult& Result : Results)
+		{
+			APawn* Member = Result.Member.Get();
+			const FMemberOrder* Order = OrdersByMember.Find(Member);
+			if(!IsValid(Member) || !Order || Order->OrderId != OrderId || Result.Points.Num() < 2)
+			{
+				continue;
+			}
+
+			FollowPath(*Member, Result);
+		}
+
+		// Members still on this order are done with it, including any destroyed while their paths were found.
+		for (auto It = OrdersByMember.CreateIterator(); It; ++It)
+		{
+			if(It.Value().OrderId == OrderId)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}));
+
+	// Cached paths complete the order straight away, leaving no member to record the batch on. Without a navigation
+	// system there is no batch and the order is dropped.
+	for (APawn* Member : Party)
+	{
+		FMemberOrder* Order = OrdersByMember.Find(Member);
+		if(!Order || Order->OrderId != OrderId)
+		{
+			continue;
+		}
+
+		if(BatchId != 0)
+		{
+			Order->BatchId = BatchId;
+		}
+		else
+		{
+			OrdersByMember.Remove(Member);
+		}
+	}
+
+	// A batch no member is waiting on any more is only wasted navmesh queries.
+	for (const uint32 SupersededBatchId : SupersededBatchIds)
+	{
+		bool bStillWaitedOn = false;
+		for (const TPair<TObjectKey<APawn>, FMemberOrder>& Pair : OrdersByMember)
+		{
+			if(Pair.Value.BatchId == SupersededBatchId)
+			{
+				bStillWaitedOn = true;
+				break;
+			}
+		}
+
+		if(!bStillWaitedOn)
+		{
+			CancelBatch(SupersededBatchId);
+		}
+	}
+
+	return BatchId;
+}
+
+void UCRPG_PartyMovementSubsystem::FollowPath(APawn& Member, const FPartyPathResult& Result)
+{
+	AController* Controller = Member.GetController();
+	if(!Controller)
+	{
+		UE_LOG(LogCRPGPartyMovement, Verbose, TEXT("%s has no controller, skipped."), *Member.GetName());
+		return;
+	}
+
+	const FNavPathSharedPtr Path = MakeShared<FNavigationPath, ESPMode::ThreadSafe>(Result.Points);
+
+	if(AAIController* AIController = Cast<AAIController>(Controller))
+	{
+		AIController->RequestMove(FAIMoveRequest(Result.Goal), Path);
+		return;
+	}
+
+	// The owning client's movement would overwrite anything the server moved a remote player's pawn along.
+	if(!Controller->IsLocalPlayerController())
+	{
+		UE_LOG(LogCRPGPartyMovement, Warning, TEXT("%s is possessed by remote player %s and can't be moved as part of a party."), *Member.GetName(), *Controller->GetName());
+		return;
+	}
+
+	// A local player's pawn follows the path with its own path following component, as SimpleMoveToLocation does.
+	UPathFollowingComponent* PathFollowing = Controller->FindComponentByClass<UPathFollowingComponent>();
+	if(!PathFollowing)
+	{
+		PathFollowing = NewObject<UPathFollowingComponent>(Controller);
+		PathFollowing->RegisterComponentWithWorld(Controller->GetWorld());
+		PathFollowing->Initialize();
+	}
+	else
+	{
+		// The player may have possessed another pawn since the component was created.
+		PathFollowing->UpdateCachedComponents();
+	}
+
+	if(!PathFollowing->IsPathFollowingAllowed())
+	{
+		UE_LOG(LogCRPGPartyMovement, Verbose, TEXT("%s can't follow paths, skipped."), *Member.GetName());
+		return;
+	}
+
+	PathFollowing->RequestMove(FAIMoveRequest(Result.Goal), Path);
+}
+
+void UCRPG_PartyMovementSubsystem::CancelBatch(uint32 BatchId)
+{
+	if(!Batches.Remove(BatchId))
+	{
+		return;
+	}
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	
+	for (auto It = PendingQueries.CreateIterator(); It; ++It)
+	{
+		if(It.Value().BatchId == BatchId)
+		{
+			if(NavSys)
+			{
+				NavSys->AbortAsyncFindPathRequest(It.Key());
+			}
+			
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UCRPG_PartyMovementSubsystem::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	FPendingQuery PendingQuery;
+	if(!PendingQueries.RemoveAndCopyValue(QueryId, PendingQuery))
+	{
+		return;
+	}
+
+	FPathBatch* Batch = Batches.Find(PendingQuery.BatchId);
+	if(!Batch)
+	{
+		return;
+	}
+
+	TArray<FVector> Points;
+	if(Result == ENavigationQueryResult::Success && Path.IsValid())
+	{
+		Points.Reserve(Path->GetPathPoints().Num());
+		for (const FNavPathPoint& PathPoint : Path->GetPathPoints())
+		{
+			Points.Add(PathPoint.Location);
+		}
+
+		// A partial path ends wherever the navmesh did, which is no answer for a later order.
+		if(!Path->IsPartial())
+		{
+			PathCache.Store(PendingQuery.Key, Points);
+		}
+	}
+
+	if(Points.Num() >= 2)
+	{
+		for (const int32 ResultIndex : PendingQuery.ResultIndices)
+		{
+			FPartyPathResult& PathResult = Batch->Results[ResultIndex];
+			PathResult.Points = Points;
+			PathResult.Points[0] = PathResult.Start;
+			
+			if(!Path->IsPartial())
+			{
+				PathResult.Points.Last() = PathResult.Goal;
+			}
+		}
+	}
+
+	if(--Batch->NumPending <= 0)
+	{
+		CompleteBatch(PendingQuery.BatchId);
+	}
+}
+
+void UCRPG_PartyMovementSubsystem::CompleteBatch(uint32 BatchId)
+{
+	FPathBatch Batch;
+	if(!Batches.RemoveAndCopyValue(BatchId, Batch))
+	{
+		return;
+	}
+
+	LastBatchLatency = FPlatformTime::Seconds() - Batch.StartTime;
+
+	SET_FLOAT_STAT(STAT_CRPGPartyMovement_BatchLatency, LastBatchLatency * 1000.0);
+	SET_FLOAT_STAT(STAT_CRPGPartyMovement_PathCacheHitRate, PathCache.GetHitRate() * 100.f);
+	CSV_CUSTOM_STAT(CRPGPartyMovement, BatchLatencyMs, static_cast<float>(LastBatchLatency * 1000.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(CRPGPartyMovement, PathCacheHitRate, PathCache.GetHitRate(), ECsvCustomStatOp::Set);
+
+	Batch.OnFound.ExecuteIfBound(Batch.Results);
+}
+
+void UCRPG_PartyMovementSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+	PathCache.Reset();
+}
@@ -0,0 +1,77 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Game/CRPG_PartyPathCache.h"
+
+// UE
+#include "NavigationData.h"
+
+FPartyPathCache::FPartyPathCache()
+	: CellSize(50.f)
+	, Hits(0)
+	, Misses(0)
+{
+}
+
+void FPartyPathCache::Init(int32 InCapacity, float InCellSize)
+{
+	Paths.Empty(FMath::Max(InCapacity, 1));
+	CellSize = FMath::Max(InCellSize, 1.f);
+	Hits = 0;
+	Misses = 0;
+}
+
+void FPartyPathCache::Reset()
+{
+	Paths.Empty(Paths.Max());
+	Hits = 0;
+	Misses = 0;
+}
+
+FPartyPathCacheKey FPartyPathCache::MakeKey(const ANavigationData* NavData, const FVector& Start, const FVector& Goal) const
+{
+	const auto ToCell = [this](const FVector& Location)
+	{
+		return FIntVector(
+			FMath::FloorToInt32(Location.X / CellSize),
+			FMath::FloorToInt32(Location.Y / CellSize),
+			FMath::FloorToInt32(Location.Z / CellSize));
+	};
+	
+	FPartyPathCacheKey Key;
+	Key.NavData = NavData;
+	Key.StartCell = ToCell(Start);
+	Key.GoalCell = ToCell(Goal);
+	return Key;
+}
+
+bool FPartyPathCache::Find(const FPartyPathCacheKey& Key, const FVector& Start, const FVector& Goal, TArray<FVector>& OutPoints)
+{
+	const TArray<FVector>* Points = Paths.FindAndTouch(Key);
+	if(!Points || Points->Num() < 2)
+	{
+		++Misses;
+		return false;
+	}
+
+	++Hits;
+
+	OutPoints = *Points;
+	OutPoints[0] = Start;
+	OutPoints.Last() = Goal;
+	return true;
+}
+
+void FPartyPathCache::Store(const FPartyPathCacheKey& Key, const TArray<FVector>& Points)
+{
+	if(Points.Num() >= 2)
+	{
+		Paths.Add(Key, Points);
+	}
+}
+
+float FPartyPathCache::GetHitRate() const
+{
+	const int32 Lookups = Hits + Misses;
+	return Lookups > 0 ? static_cast<float>(Hits) / Lookups : 0.f;
+}
@@ -0,0 +1,116 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Game/CRPG_ReplicationGraph.h"
+
+// CRPG
+#include "Player/CRPG_PlayerCamera.h"
+
+
+void UCRPG_ReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// The base graph registered every loaded camera class from its defaults, limit how far all of them reach.
+	// The period stays at the default rate until each camera sets its own.
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		if(It->IsChildOf(ACRPG_PlayerCamera::StaticClass()))
+		{
+			GlobalActorReplicationInfoMap.GetClassInfo(*It).SetCullDistanceSquared(FMath::Square(OtherPlayerCameraCullDistance));
+		}
+	}
+}
+
+void UCRPG_ReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if(!ActorInfo.Actor->IsA<ACRPG_PlayerCamera>())
+	{
+		Super::RouteAddNetworkActorToNodes(ActorInfo, GlobalInfo);
+		return;
+	}
+
+	// Connections only see the camera while it's near their viewer, which for the owner is always. Dormant idle
+	// cameras cost nothing.
+	GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+}
+
+void UCRPG_ReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	if(!ActorInfo.Actor->IsA<ACRPG_PlayerCamera>())
+	{
+		Super::RouteRemoveNetworkActorToNodes(ActorInfo);
+		return;
+	}
+
+	GridNode->RemoveActor_Dormancy(ActorInfo);
+}
+
+void UCRPG_ReplicationGraph::SetActorNetUpdateFrequency(AActor* Actor, float Frequency)
+{
+	if(FGlobalActorReplicationInfo* GlobalInfo = GlobalActorReplicationInfoMap.Find(Actor))
+	{
+		GlobalInfo->Settings.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(Frequency);
+	}
+}
+
+bool UCRPG_ReplicationGraph::GatherActorsConsideredForConnection(UNetConnection* Connection, TArray<AActor*>& OutActors)
+{
+	const TObjectPtr<UNetReplicationGraphConnection>* ConnectionManager = Connections.FindByPredicate([Connection](const UNetReplicationGraphConnection* Element)
+	{
+		return Element && Element->NetConnection == Connection;
+	});
+
+	if(!ConnectionManager || !Connection)
+	{
+		return false;
+	}
+
+	FNetViewerArray Viewers;
+	Viewers.Emplace(Connection, 0.f);
+
+	FGatheredReplicationActorLists GatheredLists;
+	const FConnectionGatherActorListParameters Parameters(Viewers, **ConnectionManager, Connection->ClientVisibleLevelNames, GetReplicationGraphFrame(), GatheredLists, false);
+
+	for (UReplicationGraphNode* Node : GlobalGraphNodes)
+	{
+		Node->GatherActorListsForConnection(Parameters);
+	}
+
+	// The base graph's only per-connection node.
+	if(UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = FindAlwaysRelevantNodeForConnection(Connection))
+	{
+		Node->GatherActorListsForConnection(Parameters);
+	}
+
+	for (const auto& List : GatheredLists.GetLists(EActorRepListTypeFlags::Default))
+	{
+		for (AActor* Actor : List)
+		{
+			OutActors.Add(Actor);
+		}
+	}
+
+	return true;
+}
+
+int32 UCRPG_ReplicationGraph::CountActorsConsideredForConnection(UNetConnection* Connection)
+{
+	TArray<AActor*> Actors;
+	return GatherActorsConsideredForConnection(Connection, Actors) ? Actors.Num() : INDEX_NONE;
+}
+
+UReplicationGraphNode_AlwaysRelevant_ForConnection* UCRPG_ReplicationGraph::FindAlwaysRelevantNodeForConnection(const UNetConnection* Connection) const
+{
+	if(!Connection)
+	{
+		return nullptr;
+	}
+
+	const FConnectionAlwaysRelevantNodePair* Pair = AlwaysRelevantForConnectionList.FindByPredicate([Connection](const FConnectionAlwaysRelevantNodePair& Element)
+	{
+		return Element.NetConnection == Connection;
+	});
+
+	return Pair ? Pair->Node : nullptr;
+}
@@ -0,0 +1,221 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Game/CRPG_SelectableActorSubsystem.h"
+
+// CRPG
+#include "Player/Selection/CRPG_SelectionFrustum.h"
+
+// UE
+#include "Algo/Sort.h"
+#include "GameFramework/Actor.h"
+
+bool UCRPG_SelectableActorSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UCRPG_SelectableActorSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Backwards, so a swap-remove only moves an entry that was already sampled.
+	for (int32 Index = Actors.Num() - 1; Index >= 0; --Index)
+	{
+		if(const AActor* Actor = Actors[Index].Get(); IsValid(Actor))
+		{
+			Locations[Index] = Actor->GetActorLocation();
+			BoundsX[Index] = static_cast<float>(Locations[Index].X);
+			BoundsY[Index] = static_cast<float>(Locations[Index].Y);
+			BoundsZ[Index] = static_cast<float>(Locations[Index].Z);
+		}
+		else
+		{
+			RemoveAt(Index);
+		}
+	}
+
+	BuildHash();
+}
+
+TStatId UCRPG_SelectableActorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCRPG_SelectableActorSubsystem, STATGROUP_Tickables);
+}
+
+void UCRPG_SelectableActorSubsystem::Register(AActor* Actor, float Radius, float HalfHeight)
+{
+	if(!IsValid(Actor) || IndicesByActor.Contains(Actor))
+	{
+		return;
+	}
+
+	IndicesByActor.Add(Actor, Actors.Num());
+	Actors.Add(Actor);
+	ActorKeys.Add(Actor);
+	Locations.Add(Actor->GetActorLocation());
+	Shapes.Add({Radius, FMath::Max(HalfHeight, Radius)});
+
+	// The sphere around the capsule, its half height reaches the caps.
+	BoundsX.Add(static_cast<float>(Locations.Last().X));
+	BoundsY.Add(static_cast<float>(Locations.Last().Y));
+	BoundsZ.Add(static_cast<float>(Locations.Last().Z));
+	BoundsRadius.Add(Shapes.Last().HalfHeight);
+}
+
+void UCRPG_SelectableActorSubsystem::Unregister(AActor* Actor)
+{
+	if(const int32* Index = IndicesByActor.Find(Actor))
+	{
+		RemoveAt(*Index);
+	}
+}
+
+void UCRPG_SelectableActorSubsystem::RemoveAt(int32 Index)
+{
+	IndicesByActor.Remove(ActorKeys[Index]);
+
+	Actors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	ActorKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Locations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Shapes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	BoundsX.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	BoundsY.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	BoundsZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	BoundsRadius.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if(ActorKeys.IsValidIndex(Index))
+	{
+		IndicesByActor[ActorKeys[Index]] = Index;
+	}
+}
+
+AActor* UCRPG_SelectableActorSubsystem::FindAlongRay(const FVector& RayStart, const FVector& RayEnd) const
+{
+	// Longest ray walked, in cells. A cursor ray from the tactical camera crosses a handful.
+	constexpr int32 MaxSteps = 256;
+
+	const FVector2D Delta(RayEnd - RayStart);
+	const int32 NumSteps = FMath::Clamp(FMath::CeilToInt32(Delta.Size() / (CellSize * 0.5f)), 1, MaxSteps);
+
+	// Cells under the ray plus their neighbours, which capsules near a cell edge spill into. Each step revisits most of
+	// the previous step's neighbours, so this is a set rather than an array searched linearly on every lookup.
+	TSet<FIntPoint, DefaultKeyFuncs<FIntPoint>, TInlineSetAllocator<64>> VisitedCells;
+	
+	AActor* ClosestActor = nullptr;
+	double ClosestDistance = TNumericLimits<double>::Max();
+	
+	for (int32 Step = 0; Step <= NumSteps; ++Step)
+	{
+		const FIntPoint StepCell = GetCell(FMath::Lerp(RayStart, RayEnd, static_cast<double>(Step) / NumSteps));
+		
+		for (int32 OffsetY = -1; OffsetY <= 1; ++OffsetY)
+		{
+			for (int32 OffsetX = -1; OffsetX <= 1; ++OffsetX)
+			{
+				const FIntPoint Cell = StepCell + FIntPoint(OffsetX, OffsetY);
+				bool bAlreadyVisited = false;
+				VisitedCells.Add(Cell, &bAlreadyVisited);
+				if(bAlreadyVisited)
+				{
+					continue;
+				}
+
+				const FCellRange* Range = Cells.Find(Cell);
+				if(!Range)
+				{
+					continue;
+				}
+
+				for (int32 Sorted = Range->Start; Sorted < Range->Start + Range->Num; ++Sorted)
+				{
+					const int32 Index = SortedIndices[Sorted];
+					if(!Locations.IsValidIndex(Index))
+					{
+						continue;
+					}
+
+					// Closest points between the ray and the capsule's axis.
+					const FShape& Shape = Shapes[Index];
+					const FVector AxisOffset(0.f, 0.f, Shape.HalfHeight - Shape.Radius);
+					
+					FVector RayPoint;
+					FVector AxisPoint;
+					FMath::SegmentDistToSegmentSafe(RayStart, RayEnd, Locations[Index] - AxisOffset, Locations[Index] + AxisOffset, RayPoint, AxisPoint);
+
+					if(FVector::DistSquared(RayPoint, AxisPoint) > FMath::Square(Shape.Radius))
+					{
+						continue;
+					}
+
+					const double Distance = FVector::DistSquared(RayStart, RayPoint);
+					if(Distance < ClosestDistance)
+					{
+						ClosestDistance = Distance;
+						ClosestActor = Actors[Index].Get();
+					}
+				}
+			}
+		}
+	}
+
+	return ClosestActor;
+}
+
+void UCRPG_SelectableActorSubsystem::FindInFrustum(const FSelectionFrustum& Frustum, TArray<TWeakObjectPtr<AActor>>& OutActors) const
+{
+	FSelectionBounds Bounds;
+	Bounds.X = BoundsX.GetData();
+	Bounds.Y = BoundsY.GetData();
+	Bounds.Z = BoundsZ.GetData();
+	Bounds.Radius = BoundsRadius.GetData();
+	Bounds.Num = BoundsX.Num();
+
+	TArray<int32> Indices;
+	SelectionFrustum::CullSpheres(Frustum, Bounds, Indices);
+
+	for (const int32 Index : Indices)
+	{
+		if(Actors[Index].IsValid())
+		{
+			OutActors.Add(Actors[Index]);
+		}
+	}
+}
+
+FIntPoint UCRPG_SelectableActorSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UCRPG_SelectableActorSubsystem::BuildHash()
+{
+	const int32 NumActors = Actors.Num();
+	
+	IndexCells.SetNum(NumActors, EAllowShrinking::No);
+	SortedIndices.SetNum(NumActors, EAllowShrinking::No);
+	for (int32 Index = 0; Index < NumActors; ++Index)
+	{
+		IndexCells[Index] = GetCell(Locations[Index]);
+		SortedIndices[Index] = Index;
+	}
+
+	Algo::Sort(SortedIndices, [this](int32 A, int32 B)
+	{
+		const FIntPoint& CellA = IndexCells[A];
+		const FIntPoint& CellB = IndexCells[B];
+		return CellA.Y != CellB.Y ? CellA.Y < CellB.Y : CellA.X < CellB.X;
+	});
+
+	Cells.Reset();
+	for (int32 Sorted = 0; Sorted < NumActors; ++Sorted)
+	{
+		FCellRange& Range = Cells.FindOrAdd(IndexCells[SortedIndices[Sorted]]);
+		if(Range.Num == 0)
+		{
+			Range.Start = Sorted;
+		}
+		
+		++Range.Num;
+	}
+}
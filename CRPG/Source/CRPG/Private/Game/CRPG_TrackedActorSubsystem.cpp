@@ -0,0 +1,130 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Game/CRPG_TrackedActorSubsystem.h"
+
+// UE
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+void FTrackedActorSampleTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if(IsValid(Subsystem))
+	{
+		Subsystem->Sample(DeltaTime);
+	}
+}
+
+FString FTrackedActorSampleTickFunction::DiagnosticMessage()
+{
+	return TEXT("UCRPG_TrackedActorSubsystem::Sample");
+}
+
+void UCRPG_TrackedActorSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	SampleTickFunction.Subsystem = this;
+	SampleTickFunction.TickGroup = TG_PostPhysics;
+	SampleTickFunction.bCanEverTick = true;
+	SampleTickFunction.bStartWithTickEnabled = true;
+	SampleTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UCRPG_TrackedActorSubsystem::Deinitialize()
+{
+	SampleTickFunction.UnRegisterTickFunction();
+	SampleTickFunction.Subsystem = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UCRPG_TrackedActorSubsystem::AddSamplePrerequisite(FTickFunction& TickFunction)
+{
+	TickFunction.AddPrerequisite(this, SampleTickFunction);
+}
+
+void UCRPG_TrackedActorSubsystem::Sample(float DeltaTime)
+{
+	for (int32 Handle = 0; Handle < Entries.Num(); ++Handle)
+	{
+		if(Entries[Handle].RefCount > 0)
+		{
+			SampleActor(Handle, DeltaTime);
+		}
+	}
+}
+
+int32 UCRPG_TrackedActorSubsystem::Register(AActor* Actor)
+{
+	if(!IsValid(Actor))
+	{
+		return INDEX_NONE;
+	}
+
+	if(const int32* ExistingHandle = HandlesByActor.Find(Actor))
+	{
+		++Entries[*ExistingHandle].RefCount;
+		return *ExistingHandle;
+	}
+
+	int32 Handle;
+	if(FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		Handle = Entries.AddDefaulted();
+		Transforms.AddDefaulted();
+		Velocities.AddDefaulted();
+	}
+
+	FEntry& Entry = Entries[Handle];
+	Entry.Actor = Actor;
+	Entry.ActorKey = Actor;
+	Entry.RefCount = 1;
+	Entry.bValid = true;
+
+	// Readable straight away, with no velocity until the next sample.
+	Transforms[Handle] = Actor->GetActorTransform();
+	Velocities[Handle] = FVector::ZeroVector;
+
+	HandlesByActor.Add(Actor, Handle);
+	return Handle;
+}
+
+void UCRPG_TrackedActorSubsystem::Unregister(int32 Handle)
+{
+	if(!Entries.IsValidIndex(Handle) || Entries[Handle].RefCount <= 0)
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries[Handle];
+	if(--Entry.RefCount > 0)
+	{
+		return;
+	}
+
+	HandlesByActor.Remove(Entry.ActorKey);
+
+	Entry = FEntry();
+	FreeHandles.Add(Handle);
+}
+
+void UCRPG_TrackedActorSubsystem::SampleActor(int32 Handle, float DeltaTime)
+{
+	FEntry& Entry = Entries[Handle];
+
+	const AActor* Actor = Entry.Actor.Get();
+	Entry.bValid = IsValid(Actor);
+	if(!Entry.bValid)
+	{
+		return;
+	}
+
+	const FTransform Transform = Actor->GetActorTransform();
+	Velocities[Handle] = DeltaTime > 0.f ? (Transform.GetLocation() - Transforms[Handle].GetLocation()) / DeltaTime : FVector::ZeroVector;
+	Transforms[Handle] = Transform;
+}
@@ -3,21 +3,122 @@
 
 #include "Player/CRPG_PlayerCamera.h"
 
+// CRPG
+#include "Game/CRPG_ReplicationGraph.h"
+#include "Game/CRPG_TrackedActorSubsystem.h"
+#include "Player/Camera/CRPG_CameraBoundsAsset.h"
+#include "Player/Camera/CRPG_CameraBoundsVolume.h"
+#include "Player/Camera/CRPG_CameraEasing.h"
+#include "Player/Camera/CRPG_CameraHeightField.h"
+#include "Player/Camera/CRPG_CameraFraming.h"
+#include "Player/Camera/CRPG_CameraStats.h"
+
 // UE
+#include "Algo/AllOf.h"
 #include "Camera/CameraComponent.h"
 #include "Components/SplineComponent.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Net/UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY(LogCRPGPlayerCamera);
 
+DECLARE_CYCLE_STAT(TEXT("Tick"), STAT_CRPGCamera_Tick, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Flush Input"), STAT_CRPGCamera_FlushInput, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Apply Input"), STAT_CRPGCamera_ApplyInput, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Server Input"), STAT_CRPGCamera_ServerInput, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Network Smoothing"), STAT_CRPGCamera_NetworkSmoothing, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Move To Destination"), STAT_CRPGCamera_MoveToDestination, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Set Transform Along Spline"), STAT_CRPGCamera_SetTransformAlongSpline, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Follow Group"), STAT_CRPGCamera_FollowGroup, STATGROUP_CRPGCamera);
+DECLARE_CYCLE_STAT(TEXT("Terrain Follow"), STAT_CRPGCamera_TerrainFollow, STATGROUP_CRPGCamera);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Terrain Traces"), STAT_CRPGCamera_TerrainTraces, STATGROUP_CRPGCamera);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Terrain Cache Hit Rate %"), STAT_CRPGCamera_TerrainCacheHitRate, STATGROUP_CRPGCamera);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Input RPC Bytes"), STAT_CRPGCamera_InputRpcBytes, STATGROUP_CRPGCamera);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ack RPC Bytes"), STAT_CRPGCamera_AckRpcBytes, STATGROUP_CRPGCamera);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Correction RPC Bytes"), STAT_CRPGCamera_CorrectionRpcBytes, STATGROUP_CRPGCamera);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Zoom Snapshot RPC Bytes"), STAT_CRPGCamera_ZoomSnapshotRpcBytes, STATGROUP_CRPGCamera);
+
+UE_TRACE_EVENT_BEGIN(CRPGCamera, CameraPrediction)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, CameraId)
+	UE_TRACE_EVENT_FIELD(uint32, Sequence)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CRPGCamera, CameraCorrection)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, CameraId)
+	UE_TRACE_EVENT_FIELD(uint32, Sequence)
+	UE_TRACE_EVENT_FIELD(float, LocationError)
+	UE_TRACE_EVENT_FIELD(float, RotationError)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CRPGCamera, CameraMoveTo)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, CameraId)
+	UE_TRACE_EVENT_FIELD(bool, bStart)
+	UE_TRACE_EVENT_FIELD(float, Duration)
+UE_TRACE_EVENT_END()
+
+namespace
+{
+	// Reports the payload size of a camera RPC to its "stat CRPGCamera" counter and, when LogCRPGPlayerCamera is at
+	// Verbose, to the log. The payload is only measured while one of them is listening.
+	template<typename... TPayload>
+	void LogMessageSize(const AActor* Camera, const TCHAR* MessageName, TStatId StatId, const TPayload&... Payload)
+	{
+		bool bCollectingStats = false;
+#if STATS
+		bCollectingStats = FThreadStats::IsCollectingData();
+#endif
+		
+		if(!bCollectingStats && !UE_LOG_ACTIVE(LogCRPGPlayerCamera, Verbose))
+		{
+			return;
+		}
+		
+		const int64 NumBits = (CameraNet::GetSerializedBits(Payload) + ...);
+		const int64 NumBytes = FMath::DivideAndRoundUp<int64>(NumBits, 8);
+#if STATS
+		SET_DWORD_STAT_FName(StatId.GetName(), NumBytes);
+#endif
+		UE_LOG(LogCRPGPlayerCamera, Verbose, TEXT("%s: %s payload %lld bits (%lld bytes)."), *Camera->GetName(), MessageName, NumBits, NumBytes);
+	}
+}
+
+static FAutoConsoleCommandWithWorld DumpCameraNetStatsCommand(
+	TEXT("CRPG.Camera.DumpNetStats"),
+	TEXT("Logs byte rates and camera ack/correction counts for every client connection. Server only."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&ACRPG_PlayerCamera::DumpNetStats));
+
+static FAutoConsoleCommandWithWorld BenchmarkZoomSplineCommand(
+	TEXT("CRPG.Camera.BenchmarkZoomSpline"),
+	TEXT("Logs the per-call cost of evaluating the zoom spline directly against the baked zoom table for every camera."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&ACRPG_PlayerCamera::BenchmarkZoomSpline));
+
 ACRPG_PlayerCamera::ACRPG_PlayerCamera()
 {
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// Follow targets are read from UCRPG_TrackedActorSubsystem, which samples them once they have moved this frame.
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
 
 	bReplicates = true;
-	bAlwaysRelevant = true;
+
+	// The owner always finds its own camera relevant. Other connections only need it near their view, which matches
+	// the replication graph's cull distance for other players' cameras.
+	bAlwaysRelevant = false;
+	NetCullDistanceSquared = FMath::Square(20000.f);
+
+	// Only non-owning connections rely on property replication, the owner is driven by input acks.
+	// The frequency is scaled between IdleNetUpdateFrequency and ActiveNetUpdateFrequency at runtime.
+	NetUpdateFrequency = 10.f;
+	MinNetUpdateFrequency = 2.f;
 
 	DefaultRootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("DefaultRootComponent"));
 	SetRootComponent(DefaultRootComponent);
@@ -35,7 +136,20 @@ ACRPG_PlayerCamera::ACRPG_PlayerCamera()
 	SplineComponent = CreateDefaultSubobject<USplineComponent>("SplineComponent");
 	SplineComponent->SetupAttachment(RootComponent);
 
-	CorrectedIndex = INDEX_NONE;	
+	CameraNetRole = ECameraNetRole::Simulated;
+
+	PendingMoveInput = FVector2D::ZeroVector;
+	PendingRotateInput = 0.f;
+	PendingZoomInput = 0.f;
+	LastAppliedInputSequence = 0;
+	LastZoomSnapshotTime = 0.0;
+
+	NetMotionAlpha = 0.f;
+	LastNetMotionLocation = FVector::ZeroVector;
+	LastNetMotionYaw = 0.f;
+	bReplicatedStateMoving = false;
+	ReplicatedStateFrame = 0;
+	
 	bPositionCorrected = false;
 	bRotationCorrected = false;
 	
@@ -46,474 +160,1142 @@ ACRPG_PlayerCamera::ACRPG_PlayerCamera()
 	CurrentTime = INDEX_NONE;
 
 	bRotationBlocked = false;
+
+	bIsFollowingTarget = false;
+	FollowTargetHandle = INDEX_NONE;
+
+	CameraCommandIndex = INDEX_NONE;
+	CameraCommandStepStartTime = 0.0;
+	CameraCommandStartTransform = FTransform::Identity;
+	CameraCommandStartZoomPercent = 0.f;
+
+	TerrainHeightOffset = 0.f;
+	TargetTerrainHeightOffset = 0.f;
+	TerrainCacheZ = 0.f;
+	LastTerrainFocus = FVector::ZeroVector;
+	TerrainTracesThisFrame = 0;
+	TerrainTraceDelegate.BindUObject(this, &ACRPG_PlayerCamera::OnTerrainTraceDone);
 }
 
-void ACRPG_PlayerCamera::BeginPlay()
+void ACRPG_PlayerCamera::OnConstruction(const FTransform& Transform)
 {
-	Super::BeginPlay();
-	
-	SetCameraTransformAlongSpline(DefaultZoomPercent);
-	ZoomPercent = DefaultZoomPercent;
+	Super::OnConstruction(Transform);
+
+	// Re-bake whenever the spline is edited.
+	BakeZoomSplineTable();
 }
 
-void ACRPG_PlayerCamera::Tick(float DeltaSeconds)
+void ACRPG_PlayerCamera::BeginPlay()
 {
-	Super::Tick(DeltaSeconds);
+	Super::BeginPlay();
 
-	if(!IsValid(GetOwner()) || !(Cast<APlayerController>(GetOwner())->IsLocalController() || HasAuthority()))
-	{			
-		return;
+	UpdateCameraNetRole();
+	MoveHistory.Init(MoveHistoryCapacity);
+
+	if(UCRPG_TrackedActorSubsystem* TrackedActorSubsystem = GetWorld()->GetSubsystem<UCRPG_TrackedActorSubsystem>())
+	{
+		TrackedActorSubsystem->AddSamplePrerequisite(PrimaryActorTick);
 	}
 
-	if(IsFollowingTarget())
+	// The spring arm also ticks in TG_PostPhysics and must lag behind this frame's camera move, not the last one.
+	SpringArmComponent->PrimaryComponentTick.AddPrerequisite(this, PrimaryActorTick);
+	SnapshotBuffer.Init(SnapshotBufferCapacity);
+
+	if(HasAuthority())
 	{
-		TickFollowTarget(DeltaSeconds);
+		LastNetMotionLocation = GetActorLocation();
+		LastNetMotionYaw = GetActorRotation().Yaw;
+		MarkNetActive();
 	}
 	
-	MoveToDestination(DeltaSeconds);
+	for (TActorIterator<ACRPG_CameraBoundsVolume> It(GetWorld()); It; ++It)
+	{
+		if(UCRPG_CameraBoundsAsset* BoundsAsset = It->GetBoundsAsset(); IsValid(BoundsAsset) && BoundsAsset->IsBaked())
+		{
+			CameraBounds = BoundsAsset;
+			break;
+		}
+	}
 	
-	NetworkSmoothing(DeltaSeconds);
+	TerrainHeightField.Init(TerrainCacheDimension, TerrainCellSize);
+	TerrainCacheZ = GetActorLocation().Z;
+	LastTerrainFocus = GetActorLocation();
+	
+	BakeZoomSplineTable();
+	SetCameraTransformAlongSpline(DefaultZoomPercent);
+	ZoomPercent = DefaultZoomPercent;
+	LastZoomSnapshot.SetZoomPercent(ZoomPercent);
 }
 
-/* ------------------------------------------------ BEGIN: Networking ----------------------------------------------- */
-
-void ACRPG_PlayerCamera::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
+void ACRPG_PlayerCamera::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(ACRPG_PlayerCamera, bRotationBlocked);
+	SetTargetToFollow(nullptr);
+	
+	Super::EndPlay(EndPlayReason);
 }
 
-void ACRPG_PlayerCamera::NetworkSmoothing(float DeltaSeconds)
+void ACRPG_PlayerCamera::Tick(float DeltaSeconds)
 {
-	if(bMovingToDestination)
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_Tick);
+	
+	Super::Tick(DeltaSeconds);
+
+	if(IsPlayingCameraCommands())
 	{
-		return;
+		TickCameraCommands();
 	}
-	
-	// Smoothly interpolate between predicted and server-confirmed position
-	if (bPositionCorrected)
-	{		
-		const FVector CurrentLocation = GetActorLocation();		
-		SetActorLocation(FMath::VInterpTo(CurrentLocation, ServerConfirmedLocation, DeltaSeconds, CameraCorrectedMovementSpeed));		
-		// Stop correcting if we're close enough to the server's position
-		bPositionCorrected = FVector::Dist(CurrentLocation, ServerConfirmedLocation) > NetworkedMovementDifference;
+	else if(IsFollowingGroup())
+	{
+		TickFollowGroup(DeltaSeconds);
 	}
-
-	if(bRotationCorrected)
+	else if(IsFollowingTarget())
 	{
-		const FRotator CurrentRotation = GetActorRotation();		
-		SetActorRotation(FMath::RInterpTo(CurrentRotation, ServerConfirmedRotation, DeltaSeconds, CameraCorrectedRotationSpeed));
+		TickFollowTarget(DeltaSeconds);
+	}
 
-		FRotator DeltaRotator = (CurrentRotation - ServerConfirmedRotation).GetNormalized();
+	// Remote cameras play back the replicated move locally.
+	MoveToDestination(DeltaSeconds);
 
-		float AngularDistance = FMath::Sqrt(
-			FMath::Square(DeltaRotator.Pitch) +
-			FMath::Square(DeltaRotator.Yaw) +
-			FMath::Square(DeltaRotator.Roll));
-				
-		bRotationCorrected = AngularDistance > NetworkedRotationDifference;
+	if(CameraNetRole == ECameraNetRole::Owner)
+	{
+		NetworkSmoothing(DeltaSeconds);
+	}
+	else if(CameraNetRole == ECameraNetRole::Simulated && !bMovingToDestination && !SnapshotBuffer.IsEmpty())
+	{
+		TickSnapshotInterpolation();
 	}
 
-	// Delete old data.
-	if(CorrectedIndex != INDEX_NONE)
+	if(HasAuthority())
 	{
-		MoveHistory.RemoveAt(0, CorrectedIndex + 1);
-		CorrectedIndex = INDEX_NONE;
+		UpdateNetUpdateFrequency(DeltaSeconds);
+		UpdateRestSnapshot();
 	}
+
+	UpdateTickEnabled();
 }
 
-/* --------------------------------------------- END: Networking ---------------------------------------------------- */
+void ACRPG_PlayerCamera::OnRep_Owner()
+{
+	Super::OnRep_Owner();
 
-/* --------------------------------------------- BEGIN: Movement ---------------------------------------------------- */
+	UpdateCameraNetRole();
+}
 
-void ACRPG_PlayerCamera::MoveCamera(FVector2D MoveToLocation)
-{
-	if(bMovingToDestination)
-	{
-		StopFollowTarget();
-		StopMoveTo();
-	}
-	
-	const FVector ForwardMovement = (GetActorForwardVector() * MoveToLocation.Y) * CameraMovementSpeed * GetWorld()->DeltaTimeSeconds;
-	const FVector RightMovement = (GetActorRightVector() * MoveToLocation.X) * CameraMovementSpeed * GetWorld()->DeltaTimeSeconds;
+/* ------------------------------------------------ BEGIN: Ticking -------------------------------------------------- */
 
-	PredictedLocation  = GetActorLocation() + ForwardMovement + RightMovement;
-	const float TimeStamp = GetWorld()->GetTimeSeconds();
-	
-	// Simulate the movement on the client side (prediction)
-	SetActorLocation(PredictedLocation);        
+void ACRPG_PlayerCamera::UpdateCameraNetRole()
+{
+	const APlayerController* OwningController = Cast<APlayerController>(GetOwner());
+	const bool bLocallyControlled = IsValid(OwningController) && OwningController->IsLocalController();
 
-	if(!HasAuthority())
+	if(HasAuthority())
 	{
-		bool bFoundMove = false;
-		for (FCameraMoveData& Move : MoveHistory)
-		{
-			if(Move.TimeStamp == TimeStamp)
-			{
-				bFoundMove = true;
-				Move.MoveToLocation = PredictedLocation;
-			}
-		}
-
-		// If there was no move with that timestamp create it and add this move.
-		if(!bFoundMove)
-		{
-			// Store the input data (for reconciliation)
-			FCameraMoveData NewMove;
-			NewMove.MoveToLocation = PredictedLocation;
-			NewMove.TimeStamp = TimeStamp;
-			
-			MoveHistory.Add(NewMove);
-		}
-		
-		SERVER_MoveCamera(MoveToLocation, TimeStamp);
+		CameraNetRole = bLocallyControlled ? ECameraNetRole::AuthorityOwner : ECameraNetRole::Authority;
 	}
 	else
 	{
-		MULTICAST_CorrectedMoveCamera(PredictedLocation, TimeStamp);
+		CameraNetRole = bLocallyControlled ? ECameraNetRole::Owner : ECameraNetRole::Simulated;
 	}
 }
 
-void ACRPG_PlayerCamera::SERVER_MoveCamera_Implementation(FVector2D MoveToLocation, float TimeStamp)
+void ACRPG_PlayerCamera::UpdateTickEnabled()
 {
-	if(bMovingToDestination)
+	const bool bNeedsTick = bMovingToDestination
+		|| IsFollowingTarget()
+		|| IsPlayingCameraCommands()
+		|| (CameraNetRole == ECameraNetRole::Owner && (bPositionCorrected || bRotationCorrected))
+		|| (CameraNetRole == ECameraNetRole::Simulated && !SnapshotBuffer.IsEmpty() && !IsSnapshotPlaybackSettled())
+		|| (HasAuthority() && NetDormancy <= DORM_Awake);
+
+	if(IsActorTickEnabled() != bNeedsTick)
 	{
-		StopFollowTarget();
-		StopMoveTo();
+		SetActorTickEnabled(bNeedsTick);
 	}
-	
-	// Recalculate the position on the server based on input
-	const FVector ForwardMovement = (GetActorForwardVector() * MoveToLocation.Y) * CameraMovementSpeed * GetWorld()->DeltaTimeSeconds;
-	const FVector RightMovement = (GetActorRightVector() * MoveToLocation.X) * CameraMovementSpeed * GetWorld()->DeltaTimeSeconds;
+}
+
+/* ------------------------------------------------ END: Ticking ---------------------------------------------------- */
+
+/* ------------------------------------------------ BEGIN: Networking ----------------------------------------------- */
 
-	const FVector NewPosition = GetActorLocation() + ForwardMovement + RightMovement;	
-	SetActorLocation(NewPosition);
+void ACRPG_PlayerCamera::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	MULTICAST_CorrectedMoveCamera(NewPosition, TimeStamp);
+	DOREPLIFETIME(ACRPG_PlayerCamera, bRotationBlocked);
+	DOREPLIFETIME_CONDITION(ACRPG_PlayerCamera, ReplicatedState, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(ACRPG_PlayerCamera, MoveToDescriptor, COND_SkipOwner);
+	DOREPLIFETIME(ACRPG_PlayerCamera, CameraCommandSchedule);
 }
 
-void ACRPG_PlayerCamera::MULTICAST_CorrectedMoveCamera_Implementation(FVector CorrectPosition, float TimeStamp)
+void ACRPG_PlayerCamera::DumpNetStats(UWorld* World)
 {
-	if (bMovingToDestination || HasAuthority())
+	if(!IsValid(World) || World->GetNetMode() == NM_Client)
 	{
 		return;
 	}
-	
-	/* TODO: Replicate Camera owner to late joining players */
-	if(!IsValid(GetOwner()))
+
+	for (TActorIterator<ACRPG_PlayerCamera> It(World); It; ++It)
 	{
-		if(bMovingToDestination)
+		const ACRPG_PlayerCamera* Camera = *It;
+		const UNetConnection* Connection = Camera->GetNetConnection();
+		if(!IsValid(Connection))
 		{
-			StopMoveTo();
+			continue;
 		}
-		
-		SetActorLocation(CorrectPosition);
-		return;
+
+		UE_LOG(LogCRPGPlayerCamera, Display, TEXT("%s [%s]: Out %d B/s, In %d B/s, Acks %u, Corrections %u, History overflows %u"),
+			*Camera->GetName(),
+			*Connection->LowLevelGetRemoteAddress(),
+			Connection->OutBytesPerSecond,
+			Connection->InBytesPerSecond,
+			Camera->NetCounters.AcksSent,
+			Camera->NetCounters.CorrectionsSent,
+			Camera->GetMoveHistoryOverflowCount());
 	}
+}
 
-	// If the owner of this actor isn't locally owned then update the position to the server position.
-	if(!Cast<APlayerController>(GetOwner())->IsLocalController())
+void ACRPG_PlayerCamera::OnRep_ReplicatedState()
+{
+	// The replicated move drives the camera until it finishes, zoom is independent of it.
+	if(bMovingToDestination)
 	{
-		if(bMovingToDestination)
+		if(ReplicatedState.HasZoomPercent())
 		{
-			StopMoveTo();
+			ZoomPercent = ReplicatedState.GetZoomPercent();
+			SetCameraTransformAlongSpline(ZoomPercent);
 		}
-		
-		SetActorLocation(CorrectPosition);
 		return;
 	}
-			
-	// Find the input data associated with this timestamp
-	for (int32 i = 0; i < MoveHistory.Num(); i++)
-	{
-		if (MoveHistory[i].TimeStamp == TimeStamp)
-		{				
-			ServerConfirmedLocation = CorrectPosition;
-
-			if(FVector::Dist(MoveHistory[i].MoveToLocation, ServerConfirmedLocation) > NetworkedMovementDifference)
-			{
-				bPositionCorrected = true;
-			}
-            
-			CorrectedIndex = (CorrectedIndex == INDEX_NONE) ? i : FMath::Min(CorrectedIndex, i);
-			break;
-		}
-	}	
-}
-
-/* --------------------------------------------- END: Movement ------------------------------------------------------ */
-
-/* --------------------------------------------- BEGIN: Rotate ------------------------------------------------------ */
 
-void ACRPG_PlayerCamera::RotateCamera(float MoveToRotation)
-{
-	PredictedRotation  = FRotator(GetActorRotation().Pitch, (MoveToRotation * CameraRotationSpeed  * GetWorld()->DeltaTimeSeconds) + GetActorRotation().Yaw, GetActorRotation().Roll);
-	const float TimeStamp = GetWorld()->GetTimeSeconds();
-	
-	if (!HasAuthority())
+	if(ShouldInterpolateSnapshots())
 	{
-		// Simulate the rotation on the client side (prediction)
-		SetActorRotation(PredictedRotation);        
-		
-		// Find if there is a move with this timestamp and add the rotation.
-		bool bFoundMove = false;
-		for (FCameraMoveData& Move : MoveHistory)
+		if(ReplicatedState.HasZoomPercent())
 		{
-			if(Move.TimeStamp == TimeStamp)
-			{
-				bFoundMove = true;
-				Move.MoveToRotation = PredictedRotation;
-			}
+			ZoomPercent = ReplicatedState.GetZoomPercent();
+			SetCameraTransformAlongSpline(ZoomPercent);
 		}
 
-		// If there was no move with that timestamp create it and add this move.
-		if(!bFoundMove)
-		{
-			// Store the input data (for reconciliation)
-			FCameraMoveData NewMove;
-			NewMove.MoveToRotation = PredictedRotation;
-			NewMove.TimeStamp = TimeStamp;
-			
-			MoveHistory.Add(NewMove);
-		}		
+		AddSnapshot(ReplicatedState);
+		return;
 	}
-
-	SERVER_RotateCamera(MoveToRotation, TimeStamp);
+	
+	ApplyNetState(ReplicatedState);
 }
 
-void ACRPG_PlayerCamera::SERVER_RotateCamera_Implementation(float MoveToRotation, float TimeStamp)
+void ACRPG_PlayerCamera::UpdateReplicatedState()
 {
-	// Recalculate the rotation on the server based on input
-	const FRotator NewRotation = FRotator(GetActorRotation().Pitch, (MoveToRotation * CameraRotationSpeed * GetWorld()->DeltaTimeSeconds) + GetActorRotation().Yaw, GetActorRotation().Roll);
-	
-	SetActorRotation(NewRotation);
+	ReplicatedState.SetLocation(GetActorLocation());
+	ReplicatedState.SetYaw(GetActorRotation().Yaw);
+	ReplicatedState.SetServerTime(GetServerWorldTimeSeconds());
+
+	bReplicatedStateMoving = true;
+	ReplicatedStateFrame = GFrameCounter;
 
-	MULTICAST_CorrectedRotateCamera(NewRotation, TimeStamp);
+	MarkNetActive();
 }
 
-void ACRPG_PlayerCamera::MULTICAST_CorrectedRotateCamera_Implementation(FRotator CorrectRotation, float TimeStamp)
+void ACRPG_PlayerCamera::UpdateRestSnapshot()
 {
-	if (!HasAuthority())
+	// Nothing changed for a whole frame, send a still snapshot straight away rather than let remote cameras extrapolate.
+	if(bReplicatedStateMoving && GFrameCounter > ReplicatedStateFrame + 1)
 	{
-		/* TODO: Replicate Camera owner to late joining players */
-		if(!IsValid(GetOwner()))
-		{			
-			SetActorRotation(CorrectRotation);
-			return;
-		}
-
-		// If the owner of this actor isn't locally owned then update the rotation to the server rotation.
-		if(!Cast<APlayerController>(GetOwner())->IsLocalController())
-		{
-			SetActorRotation(CorrectRotation);
-			return;
-		}
-				
-		// Find the input data associated with this timestamp
-		for (int32 i = 0; i < MoveHistory.Num(); i++)
-		{
-			if (MoveHistory[i].TimeStamp == TimeStamp)
-			{				
-				ServerConfirmedRotation = CorrectRotation;
-
-				FRotator DeltaRotator = (MoveHistory[i].MoveToRotation - ServerConfirmedRotation).GetNormalized();
-
-				float AngularDistance = FMath::Sqrt(
-					FMath::Square(DeltaRotator.Pitch) +
-					FMath::Square(DeltaRotator.Yaw) +
-					FMath::Square(DeltaRotator.Roll));
-				
-				if(AngularDistance > NetworkedRotationDifference)
-				{
-					bRotationCorrected = true;
-				}
-
-				CorrectedIndex = (CorrectedIndex == INDEX_NONE) ? i : FMath::Min(CorrectedIndex, i);
-				break;
-			}
-		}
+		ReplicatedState.SetServerTime(GetServerWorldTimeSeconds());
+		bReplicatedStateMoving = false;
+		ForceNetUpdate();
 	}
 }
 
-/* --------------------------------------------- END: Rotate -------------------------------------------------------- */
-
-/* --------------------------------------------- BEGIN: Zoom -------------------------------------------------------- */
+bool ACRPG_PlayerCamera::ShouldInterpolateSnapshots() const
+{
+	return bInterpolateRemoteCameras
+		&& CameraNetRole == ECameraNetRole::Simulated
+		&& ReplicatedState.HasLocation()
+		&& ReplicatedState.HasServerTime();
+}
 
-void ACRPG_PlayerCamera::ZoomCamera(float InputZoom)
+void ACRPG_PlayerCamera::AddSnapshot(const FCameraNetState& State)
 {
-	ZoomPercent = FMath::Clamp((ZoomSpeed * InputZoom * GetWorld()->DeltaTimeSeconds) + ZoomPercent, 0.f, 1.f);
-	SetCameraTransformAlongSpline(ZoomPercent);
+	FCameraSnapshot Snapshot;
+	Snapshot.Time = State.ResolveServerTime(GetServerWorldTimeSeconds());
+	Snapshot.Location = State.GetLocation();
+	Snapshot.Yaw = State.GetYaw();
 
-	if(!HasAuthority())
+	if(SnapshotBuffer.IsEmpty())
 	{
-		SERVER_ZoomCamera(InputZoom);
+		// Nothing to play back from yet, start where the server is.
+		const FRotator CurrentRotation = GetActorRotation();
+		SetActorLocationAndRotation(Snapshot.Location, FRotator(CurrentRotation.Pitch, Snapshot.Yaw, CurrentRotation.Roll));
 	}
-	else
+	else if(IsSnapshotPlaybackSettled())
 	{
-		MULTICAST_ZoomCamera(ZoomPercent);
+		// The camera was at rest, so it left its last snapshot at most one update interval before this one.
+		FCameraSnapshot RestSnapshot = SnapshotBuffer.GetNewest();
+		RestSnapshot.Time = FMath::Max(RestSnapshot.Time, Snapshot.Time - 1.0 / ActiveNetUpdateFrequency);
+		SnapshotBuffer.Reset();
+		SnapshotBuffer.Add(RestSnapshot);
 	}
-}
 
-void ACRPG_PlayerCamera::SERVER_ZoomCamera_Implementation(float InputZoom)
-{
-	ZoomCamera(InputZoom);
+	SnapshotBuffer.Add(Snapshot);
+	UpdateTickEnabled();
 }
 
-void ACRPG_PlayerCamera::MULTICAST_ZoomCamera_Implementation(float NewZoomPercent)
+void ACRPG_PlayerCamera::TickSnapshotInterpolation()
 {
-	/* TODO: Replicate Camera owner to late joining players */
-	if(!IsValid(GetOwner()) || !Cast<APlayerController>(GetOwner())->IsLocalController())
+	const double PlaybackTime = GetServerWorldTimeSeconds() - SnapshotInterpolationDelay;
+
+	FCameraSnapshot Snapshot;
+	if(SnapshotBuffer.Sample(PlaybackTime, SnapshotMaxExtrapolation, Snapshot))
 	{
-		ZoomPercent = NewZoomPercent;
-		SetCameraTransformAlongSpline(NewZoomPercent);
+		const FRotator CurrentRotation = GetActorRotation();
+		SetActorLocationAndRotation(Snapshot.Location, FRotator(CurrentRotation.Pitch, Snapshot.Yaw, CurrentRotation.Roll));
 	}
-}
 
-void ACRPG_PlayerCamera::SetCameraTransformAlongSpline(float ZoomPercentage) const  
-{  
-	if(!SpringArmComponent || !SplineComponent)  
-	{       return;  
-	}
+	SnapshotBuffer.Trim(PlaybackTime);
+}
 
-	SpringArmComponent->SetWorldLocation(SplineComponent->GetLocationAtTime(ZoomPercentage, ESplineCoordinateSpace::World));   ;  
-	SpringArmComponent->SetWorldRotation(UKismetMathLibrary::FindLookAtRotation(SpringArmComponent->GetComponentLocation(), GetActorLocation()));  
+bool ACRPG_PlayerCamera::IsSnapshotPlaybackSettled() const
+{
+	return GetServerWorldTimeSeconds() - SnapshotInterpolationDelay > SnapshotBuffer.GetNewest().Time + SnapshotMaxExtrapolation;
 }
 
-/* --------------------------------------------- END: Zoom ---------------------------------------------------------- */
+void ACRPG_PlayerCamera::ApplyNetState(const FCameraNetState& State)
+{
+	if(State.HasLocation())
+	{
+		SetActorLocation(State.GetLocation());
+	}
 
-/* --------------------------------------------- BEGIN: Move To Location -------------------------------------------- */
+	if(State.HasYaw())
+	{
+		const FRotator CurrentRotation = GetActorRotation();
+		SetActorRotation(FRotator(CurrentRotation.Pitch, State.GetYaw(), CurrentRotation.Roll));
+	}
 
-void ACRPG_PlayerCamera::MoveTo(const FTransform Destination)
-{
-	// Clear off network smoothing for any previous moves.
-	bPositionCorrected = false;
-	bRotationCorrected = false;
-	CorrectedIndex = INDEX_NONE;
-	
-	CameraStart = GetActorTransform();
-	CameraDestination = Destination;
-		
-	float Distance = FVector::Distance(CameraStart.GetLocation(), CameraDestination.GetLocation());
-	TotalDuration = FMath::GetMappedRangeValueClamped(FVector2D(0.0f, MaxMoveToDestinationBeforeMaxSpeed), FVector2D(MinMoveToDuration, MaxMoveToDuration), Distance);
-	CurrentTime = 0.f;		
-	
-	bMovingToDestination = true;
-	
-	if(!HasAuthority())
+	if(State.HasZoomPercent())
 	{
-		SERVER_MoveTo(Destination);
+		ZoomPercent = State.GetZoomPercent();
+		SetCameraTransformAlongSpline(ZoomPercent);
 	}
 }
 
-void ACRPG_PlayerCamera::SERVER_MoveTo_Implementation(const FTransform Destination)
+void ACRPG_PlayerCamera::MarkNetActive()
 {
-	MoveTo(Destination);
+	if(NetDormancy > DORM_Awake)
+	{
+		SetNetDormancy(DORM_Awake);
+	}
+
+	GetWorldTimerManager().SetTimer(NetDormancyTimerHandle, this, &ACRPG_PlayerCamera::TryEnterNetDormancy, NetDormancyDelay);
+	UpdateTickEnabled();
 }
 
-void ACRPG_PlayerCamera::StopMoveTo()
+void ACRPG_PlayerCamera::TryEnterNetDormancy()
 {
-	bMovingToDestination = false;
-	
-	if(!HasAuthority())
+	if(bMovingToDestination || IsFollowingTarget() || IsPlayingCameraCommands())
 	{
-		SERVER_StopMoveTo();
+		GetWorldTimerManager().SetTimer(NetDormancyTimerHandle, this, &ACRPG_PlayerCamera::TryEnterNetDormancy, NetDormancyDelay);
+		return;
 	}
-}
 
-void ACRPG_PlayerCamera::SERVER_StopMoveTo_Implementation()
-{
-	StopMoveTo();
+	NetMotionAlpha = 0.f;
+	ApplyNetUpdateFrequency(IdleNetUpdateFrequency);
+	SetNetDormancy(DORM_DormantAll);
+	UpdateTickEnabled();
 }
 
-void ACRPG_PlayerCamera::MoveToDestination(float DeltaSeconds)
+void ACRPG_PlayerCamera::UpdateNetUpdateFrequency(float DeltaSeconds)
 {
-	if(!bMovingToDestination)
+	if(DeltaSeconds <= 0.f || NetDormancy > DORM_Awake)
 	{
 		return;
 	}
-	
-	CurrentTime += DeltaSeconds;
 
-	// Smooth the in and out of the move to.
-	float Alpha = FMath::Clamp(CurrentTime / TotalDuration, 0.0f, 1.0f);
-	Alpha = Alpha < 0.5f
-		? 4.0f * Alpha * Alpha * Alpha
-		: 1.0f - FMath::Pow(-2.0f * Alpha + 2.0f, 3.0f) / 2.0f;
+	const FVector Location = GetActorLocation();
+	const float Yaw = GetActorRotation().Yaw;
 
-	FTransform NewTransform = FTransform::Identity;
-	NewTransform.SetLocation(FMath::Lerp(CameraStart.GetLocation(), CameraDestination.GetLocation(), Alpha));
-	if(bRotationBlocked)
-	{		
-		NewTransform.SetRotation(FQuat::Slerp(CameraStart.GetRotation(), CameraDestination.GetRotation(), Alpha));
-		SetActorTransform(NewTransform);
-	}
-	else
-	{
-		SetActorLocation(NewTransform.GetLocation());
-	}
+	const float MovementAlpha = (FVector::Dist(Location, LastNetMotionLocation) / DeltaSeconds) / MovementSpeedForActiveNetUpdateFrequency;
+	const float RotationAlpha = (FMath::Abs(FRotator::NormalizeAxis(Yaw - LastNetMotionYaw)) / DeltaSeconds) / RotationSpeedForActiveNetUpdateFrequency;
+	const float TargetAlpha = FMath::Clamp(FMath::Max(MovementAlpha, RotationAlpha), 0.f, 1.f);
 
-	if (Alpha >= 1.0f && !IsFollowingTarget())
-	{
-		StopMoveTo();
-	}
+	// Rise instantly so motion starts replicating at full rate, decay smoothly once it stops.
+	NetMotionAlpha = (TargetAlpha > NetMotionAlpha) ? TargetAlpha : FMath::FInterpTo(NetMotionAlpha, TargetAlpha, DeltaSeconds, 1.f);
+	ApplyNetUpdateFrequency(FMath::Lerp(IdleNetUpdateFrequency, ActiveNetUpdateFrequency, NetMotionAlpha));
 
-	if(HasAuthority())
-	{
-		MULTICAST_MoveToDestination(NewTransform);
-	}
+	LastNetMotionLocation = Location;
+	LastNetMotionYaw = Yaw;
 }
 
-void ACRPG_PlayerCamera::MULTICAST_MoveToDestination_Implementation(FTransform NewTransform)
+void ACRPG_PlayerCamera::ApplyNetUpdateFrequency(float Frequency)
 {
-	// If the owner of this actor isn't locally owned then update the transform to the server transform.
-	if(!IsValid(Cast<APlayerController>(GetOwner())) || !Cast<APlayerController>(GetOwner())->IsLocalController())
+	NetUpdateFrequency = Frequency;
+
+	const UNetDriver* NetDriver = GetNetDriver();
+	if(UCRPG_ReplicationGraph* ReplicationGraph = NetDriver ? Cast<UCRPG_ReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
 	{
-		if(bRotationBlocked)
-		{		
-			SetActorTransform(NewTransform);
-		}
-		else
-		{
-			SetActorLocation(NewTransform.GetLocation());
-		}
+		ReplicationGraph->SetActorNetUpdateFrequency(this, Frequency);
 	}
 }
 
-/* --------------------------------------------- END: Move To Location ---------------------------------------------- */
-
-/* --------------------------------------------- BEGIN: Follow Target ----------------------------------------------- */
-
-void ACRPG_PlayerCamera::FollowTarget(AActor* ActorToFollow, bool bLockRotation /* = false */)
+void ACRPG_PlayerCamera::NetworkSmoothing(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_NetworkSmoothing);
+	
+	if(bMovingToDestination)
+	{
+		return;
+	}
+
+	CSV_CUSTOM_STAT(CRPGCamera, ActiveCorrections, static_cast<int32>(bPositionCorrected) + static_cast<int32>(bRotationCorrected), ECsvCustomStatOp::Accumulate);
+	
+	// Smoothly interpolate between predicted and server-confirmed position
+	if (bPositionCorrected)
+	{		
+		const FVector CurrentLocation = GetActorLocation();		
+		SetActorLocation(FMath::VInterpTo(CurrentLocation, ServerConfirmedLocation, DeltaSeconds, CameraCorrectedMovementSpeed));		
+		// Stop correcting if we're close enough to the server's position
+		bPositionCorrected = FVector::Dist(CurrentLocation, ServerConfirmedLocation) > NetworkedMovementDifference;
+	}
+
+	if(bRotationCorrected)
+	{
+		const FRotator CurrentRotation = GetActorRotation();		
+		SetActorRotation(FMath::RInterpTo(CurrentRotation, ServerConfirmedRotation, DeltaSeconds, CameraCorrectedRotationSpeed));
+
+		bRotationCorrected = CameraSimulation::GetAngularDistance(CurrentRotation, ServerConfirmedRotation) > NetworkedRotationDifference;
+	}
+}
+
+/* --------------------------------------------- END: Networking ---------------------------------------------------- */
+
+/* --------------------------------------------- BEGIN: Input ------------------------------------------------------- */
+
+void ACRPG_PlayerCamera::FlushCameraInput(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_FlushInput);
+
+	// A command sequence owns the camera until it finishes, drop player input meanwhile.
+	if(IsPlayingCameraCommands())
+	{
+		PendingMoveInput = FVector2D::ZeroVector;
+		PendingRotateInput = 0.f;
+		PendingZoomInput = 0.f;
+	}
+	
+	FCameraInputCommand Command;
+	Command.SetMove(PendingMoveInput);
+	Command.SetYaw(PendingRotateInput);
+	Command.SetZoom(PendingZoomInput);
+	Command.SetDeltaSeconds(DeltaSeconds);
+
+	PendingMoveInput = FVector2D::ZeroVector;
+	PendingRotateInput = 0.f;
+	PendingZoomInput = 0.f;
+
+	if(!Command.IsEmpty())
+	{
+		// Simulate the input with the same quantized values the server will receive (prediction).
+		ApplyInputCommand(Command);
+
+		if(HasAuthority())
+		{
+			UpdateReplicatedState();
+
+			if(Command.HasZoom())
+			{
+				ReplicateZoom();
+			}
+			return;
+		}
+
+		// Client authoritative zoom never reaches the server as input.
+		if(bClientAuthoritativeZoom)
+		{
+			Command.SetZoom(0.f);
+		}
+	}
+
+	if(bClientAuthoritativeZoom && !HasAuthority())
+	{
+		SendZoomSnapshot();
+	}
+
+	if(!Command.IsEmpty())
+	{
+		// Store the result (for reconciliation)
+		const uint32 OverflowCount = MoveHistory.GetOverflowCount();
+		
+		FCameraMoveData& Move = MoveHistory.Add();
+		Move.MoveToLocation = GetActorLocation();
+		Move.MoveToRotation = GetActorRotation();
+
+		if(OverflowCount != MoveHistory.GetOverflowCount())
+		{
+			UE_LOG(LogCRPGPlayerCamera, Verbose, TEXT("%s: Move history full, dropped unacknowledged move (%u dropped in total)."), *GetName(), MoveHistory.GetOverflowCount());
+		}
+
+		Command.Sequence = Move.Sequence;
+		PendingInputCommands.Add(Command);
+
+		UE_TRACE_LOG(CRPGCamera, CameraPrediction, CRPGCameraChannel)
+			<< CameraPrediction.Cycle(FPlatformTime::Cycles64())
+			<< CameraPrediction.CameraId(GetUniqueID())
+			<< CameraPrediction.Sequence(Move.Sequence);
+	}
+
+	if(!HasAuthority())
+	{
+		CSV_CUSTOM_STAT(CRPGCamera, MoveHistoryLength, MoveHistory.Num(), ECsvCustomStatOp::Set);
+	}
+
+	// Don't hold bundled input back once the player stops giving any.
+	if(PendingInputCommands.Num() >= InputFramesPerPacket || (Command.IsEmpty() && PendingInputCommands.Num() > 0))
+	{
+		FCameraNetState ClientState;
+		ClientState.SetLocation(GetActorLocation());
+		ClientState.SetYaw(GetActorRotation().Yaw);
+
+		FCameraInputCommandBatch Batch;
+		Batch.Commands = MoveTemp(PendingInputCommands);
+		PendingInputCommands.Reset();
+
+		LogMessageSize(this, TEXT("SERVER_CameraInput"), GET_STATID(STAT_CRPGCamera_InputRpcBytes), Batch, ClientState);
+		SERVER_CameraInput(Batch, ClientState);
+		++NetCounters.InputRpcsSent;
+		CSV_CUSTOM_STAT(CRPGCamera, InputRpcsSent, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void ACRPG_PlayerCamera::SERVER_CameraInput_Implementation(const FCameraInputCommandBatch& Batch, FCameraNetState ClientState)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_ServerInput);
+	
+	++NetCounters.InputRpcsReceived;
+	CSV_CUSTOM_STAT(CRPGCamera, InputRpcsReceived, 1, ECsvCustomStatOp::Accumulate);
+	
+	const uint32 PreviousSequence = LastAppliedInputSequence;
+	bool bZoomed = false;
+
+	// Commands can't cover more time than has passed on the server, whatever frame times the client claims.
+	InputTimeBudget.Refill(GetWorld()->GetTimeSeconds());
+	
+	const int32 NumCut = CameraNet::AcceptInputCommands(Batch, LastAppliedInputSequence, InputTimeBudget, [this, &bZoomed](const FCameraInputCommand& Command)
+	{
+		ApplyInputCommand(Command);
+		bZoomed |= Command.HasZoom();
+	});
+
+	if(NumCut > 0)
+	{
+		UE_LOG(LogCRPGPlayerCamera, Verbose, TEXT("%s: Cut the frame time of %d input commands to the time budget."), *GetName(), NumCut);
+	}
+
+	if(LastAppliedInputSequence == PreviousSequence)
+	{
+		return;
+	}
+
+	UpdateReplicatedState();
+
+	if(bZoomed)
+	{
+		ReplicateZoom();
+	}
+
+	const FRotator CurrentRotation = GetActorRotation();
+	const FRotator ClientRotation(CurrentRotation.Pitch, ClientState.GetYaw(), CurrentRotation.Roll);
+
+	// Only send the server's state back to the owner when its prediction has diverged.
+	if(FVector::Dist(ClientState.GetLocation(), GetActorLocation()) > NetworkedMovementDifference
+		|| CameraSimulation::GetAngularDistance(ClientRotation, CurrentRotation) > NetworkedRotationDifference)
+	{
+		FCameraNetState Correction;
+		Correction.SetLocation(GetActorLocation());
+		Correction.SetYaw(CurrentRotation.Yaw);
+		Correction.SetSequence(LastAppliedInputSequence);
+
+		LogMessageSize(this, TEXT("CLIENT_CorrectCameraInput"), GET_STATID(STAT_CRPGCamera_CorrectionRpcBytes), Correction);
+		CLIENT_CorrectCameraInput(Correction);
+		++NetCounters.CorrectionsSent;
+		CSV_CUSTOM_STAT(CRPGCamera, CorrectionsSent, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else
+	{
+		FCameraNetState Ack;
+		Ack.SetSequence(LastAppliedInputSequence);
+
+		LogMessageSize(this, TEXT("CLIENT_AckCameraInput"), GET_STATID(STAT_CRPGCamera_AckRpcBytes), Ack);
+		CLIENT_AckCameraInput(Ack);
+		++NetCounters.AcksSent;
+		CSV_CUSTOM_STAT(CRPGCamera, AcksSent, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void ACRPG_PlayerCamera::CLIENT_AckCameraInput_Implementation(FCameraNetState Ack)
+{
+	// Delete old data.
+	MoveHistory.Acknowledge(Ack.ResolveSequence(MoveHistory.GetNextSequence()));
+}
+
+void ACRPG_PlayerCamera::CLIENT_CorrectCameraInput_Implementation(FCameraNetState Correction)
+{
+	if(bMovingToDestination)
+	{
+		return;
+	}
+
+	++NetCounters.CorrectionsReceived;
+	CSV_CUSTOM_STAT(CRPGCamera, CorrectionsReceived, 1, ECsvCustomStatOp::Accumulate);
+	
+	const uint32 Sequence = Correction.ResolveSequence(MoveHistory.GetNextSequence());
+	
+	// Find the input data associated with this sequence
+	if(const FCameraMoveData* Move = MoveHistory.Find(Sequence))
+	{
+		const FRotator CurrentRotation = GetActorRotation();
+		
+		ServerConfirmedLocation = Correction.GetLocation();
+		ServerConfirmedRotation = FRotator(CurrentRotation.Pitch, Correction.GetYaw(), CurrentRotation.Roll);
+
+		if(FVector::Dist(Move->MoveToLocation, ServerConfirmedLocation) > NetworkedMovementDifference)
+		{
+			bPositionCorrected = true;
+		}
+
+		if(CameraSimulation::GetAngularDistance(Move->MoveToRotation, ServerConfirmedRotation) > NetworkedRotationDifference)
+		{
+			bRotationCorrected = true;
+		}
+
+		UE_TRACE_LOG(CRPGCamera, CameraCorrection, CRPGCameraChannel)
+			<< CameraCorrection.Cycle(FPlatformTime::Cycles64())
+			<< CameraCorrection.CameraId(GetUniqueID())
+			<< CameraCorrection.Sequence(Sequence)
+			<< CameraCorrection.LocationError(static_cast<float>(FVector::Dist(Move->MoveToLocation, ServerConfirmedLocation)))
+			<< CameraCorrection.RotationError(CameraSimulation::GetAngularDistance(Move->MoveToRotation, ServerConfirmedRotation));
+
+		// Delete old data.
+		MoveHistory.Acknowledge(Sequence);
+		UpdateTickEnabled();
+	}
+}
+
+void ACRPG_PlayerCamera::ApplyInputCommand(const FCameraInputCommand& Command)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_ApplyInput);
+	
+	if(Command.HasMove() && bMovingToDestination)
+	{
+		StopFollowTarget();
+		StopMoveTo();
+	}
+
+	const FRotator CurrentRotation = GetActorRotation();
+	
+	FCameraSimulationState State;
+	State.Location = GetActorLocation();
+	State.Yaw = CurrentRotation.Yaw;
+	State.ZoomPercent = ZoomPercent;
+
+	const FCameraSimulationState NewState = CameraSimulation::Step(State, Command, GetSimulationSettings());
+
+	// Both the owner's prediction and the server clamp here against the same grid, so they stay in agreement.
+	const FVector NewLocation = ClampToCameraBounds(State.Location, NewState.Location);
+	
+	SetActorLocationAndRotation(NewLocation, FRotator(CurrentRotation.Pitch, NewState.Yaw, CurrentRotation.Roll));
+
+	if(Command.HasZoom())
+	{
+		ZoomPercent = NewState.ZoomPercent;
+		SetCameraTransformAlongSpline(ZoomPercent);
+	}
+}
+
+FCameraSimulationSettings ACRPG_PlayerCamera::GetSimulationSettings() const
+{
+	FCameraSimulationSettings Settings;
+	Settings.MovementSpeed = CameraMovementSpeed;
+	Settings.RotationSpeed = CameraRotationSpeed;
+	Settings.ZoomSpeed = ZoomSpeed;
+	Settings.FixedStep = InputSimulationFixedStep;
+	return Settings;
+}
+
+/* --------------------------------------------- END: Input --------------------------------------------------------- */
+
+/* --------------------------------------------- BEGIN: Movement ---------------------------------------------------- */
+
+void ACRPG_PlayerCamera::MoveCamera(FVector2D MoveToLocation)
+{
+	PendingMoveInput += MoveToLocation;
+}
+
+FVector ACRPG_PlayerCamera::ClampToCameraBounds(const FVector& From, const FVector& To) const
+{
+	return IsValid(CameraBounds) ? CameraBounds->Clamp(From, To) : To;
+}
+
+/* --------------------------------------------- END: Movement ------------------------------------------------------ */
+
+/* --------------------------------------------- BEGIN: Rotate ------------------------------------------------------ */
+
+void ACRPG_PlayerCamera::RotateCamera(float MoveToRotation)
+{
+	PendingRotateInput += MoveToRotation;
+}
+
+/* --------------------------------------------- END: Rotate -------------------------------------------------------- */
+
+/* --------------------------------------------- BEGIN: Zoom -------------------------------------------------------- */
+
+void ACRPG_PlayerCamera::ZoomCamera(float InputZoom)
+{
+	PendingZoomInput += InputZoom;
+}
+
+void ACRPG_PlayerCamera::MULTICAST_ZoomCamera_Implementation(FCameraNetState ZoomState)
+{
+	if(!IsLocallyControlledCamera())
+	{
+		ApplyNetState(ZoomState);
+	}
+}
+
+void ACRPG_PlayerCamera::SERVER_ZoomSnapshot_Implementation(FCameraNetState ZoomState)
+{
+	if(!bClientAuthoritativeZoom || !ZoomState.HasZoomPercent())
+	{
+		return;
+	}
+
+	ZoomPercent = ZoomState.GetZoomPercent();
+	SetCameraTransformAlongSpline(ZoomPercent);
+	ReplicateZoom();
+}
+
+void ACRPG_PlayerCamera::SendZoomSnapshot()
+{
+	const double CurrentTimeSeconds = GetWorld()->GetTimeSeconds();
+	if(CurrentTimeSeconds - LastZoomSnapshotTime < ZoomSnapshotInterval)
+	{
+		return;
+	}
+
+	// Compare quantized so sub-step changes don't produce a snapshot.
+	FCameraNetState ZoomState;
+	ZoomState.SetZoomPercent(ZoomPercent);
+	if(ZoomState == LastZoomSnapshot)
+	{
+		return;
+	}
+
+	LastZoomSnapshot = ZoomState;
+	LastZoomSnapshotTime = CurrentTimeSeconds;
+
+	LogMessageSize(this, TEXT("SERVER_ZoomSnapshot"), GET_STATID(STAT_CRPGCamera_ZoomSnapshotRpcBytes), ZoomState);
+	SERVER_ZoomSnapshot(ZoomState);
+	++NetCounters.ZoomSnapshotsSent;
+	CSV_CUSTOM_STAT(CRPGCamera, ZoomSnapshotsSent, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void ACRPG_PlayerCamera::ReplicateZoom()
+{
+	if(bClientAuthoritativeZoom)
+	{
+		// Only connections the camera is relevant to receive it, at the camera's net update frequency.
+		ReplicatedState.SetZoomPercent(ZoomPercent);
+		MarkNetActive();
+		return;
+	}
+
+	FCameraNetState ZoomState;
+	ZoomState.SetZoomPercent(ZoomPercent);
+	MULTICAST_ZoomCamera(ZoomState);
+}
+
+void ACRPG_PlayerCamera::SetCameraTransformAlongSpline(float ZoomPercentage) const  
+{  
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_SetTransformAlongSpline);
+	
+	if(!SpringArmComponent || !ZoomTable.IsBaked())  
+	{
+		return;  
+	}
+
+	const FTransform ZoomTransform = ZoomTable.Sample(ZoomPercentage);
+	SpringArmComponent->SetRelativeLocationAndRotation(ZoomTransform.GetLocation() + FVector(0.f, 0.f, TerrainHeightOffset), ZoomTransform.GetRotation());
+}
+
+void ACRPG_PlayerCamera::BakeZoomSplineTable()
+{
+	ZoomTable.Reset();
+	
+	if(!SpringArmComponent || !SplineComponent)
+	{
+		return;
+	}
+
+	// The table is relative to the spring arm's parent, which stays fixed relative to the actor.
+	const USceneComponent* SpringArmParent = SpringArmComponent->GetAttachParent();
+	const FTransform ParentTransform = SpringArmParent ? SpringArmParent->GetComponentTransform() : GetActorTransform();
+	const FTransform SplineToParent = SplineComponent->GetComponentTransform().GetRelativeTransform(ParentTransform);
+	const FVector LookAtLocation = ParentTransform.InverseTransformPosition(GetActorLocation());
+
+	ZoomTable.Bake(*SplineComponent, SplineToParent, LookAtLocation, ZoomSplineTableResolution);
+}
+
+void ACRPG_PlayerCamera::BenchmarkZoomSpline(UWorld* World)
+{
+	if(!IsValid(World))
+	{
+		return;
+	}
+
+	constexpr int32 NumCalls = 10000;
+	
+	for (TActorIterator<ACRPG_PlayerCamera> It(World); It; ++It)
+	{
+		const ACRPG_PlayerCamera* Camera = *It;
+		if(!Camera->SpringArmComponent || !Camera->SplineComponent || !Camera->ZoomTable.IsBaked())
+		{
+			continue;
+		}
+
+		// Spline path as it was before the table: evaluate the spline, look at the actor and write two world transforms.
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Call = 0; Call < NumCalls; ++Call)
+		{
+			const float ZoomPercentage = static_cast<float>(Call) / NumCalls;
+			Camera->SpringArmComponent->SetWorldLocation(Camera->SplineComponent->GetLocationAtTime(ZoomPercentage, ESplineCoordinateSpace::World));
+			Camera->SpringArmComponent->SetWorldRotation(UKismetMathLibrary::FindLookAtRotation(Camera->SpringArmComponent->GetComponentLocation(), Camera->GetActorLocation()));
+		}
+		const double SplineSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Call = 0; Call < NumCalls; ++Call)
+		{
+			Camera->SetCameraTransformAlongSpline(static_cast<float>(Call) / NumCalls);
+		}
+		const double TableSeconds = FPlatformTime::Seconds() - StartTime;
+
+		// Restore the camera's actual zoom.
+		Camera->SetCameraTransformAlongSpline(Camera->ZoomPercent);
+
+		UE_LOG(LogCRPGPlayerCamera, Display, TEXT("%s: Spline %.1f ns/call, Table %.1f ns/call (%.2fx) over %d calls"),
+			*Camera->GetName(),
+			SplineSeconds * 1e9 / NumCalls,
+			TableSeconds * 1e9 / NumCalls,
+			TableSeconds > 0.0 ? SplineSeconds / TableSeconds : 0.0,
+			NumCalls);
+	}
+}
+
+/* --------------------------------------------- END: Zoom ---------------------------------------------------------- */
+
+/* --------------------------------------------- BEGIN: Terrain ----------------------------------------------------- */
+
+void ACRPG_PlayerCamera::TickTerrainFollow(float DeltaSeconds)
+{
+	if(!bFollowTerrain || !TerrainHeightField.IsInitialized())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_TerrainFollow);
+
+	const FVector Focus = GetActorLocation();
+	
+	// Traces start from the camera's plane, a move to another level starts a fresh cache.
+	if(FMath::Abs(Focus.Z - TerrainCacheZ) > TerrainHeightField.GetCellSize())
+	{
+		TerrainHeightField.Reset();
+		TerrainCacheZ = Focus.Z;
+	}
+
+	// The traces land next frame, so request the points the camera is about to reach as well as the current ones.
+	const FVector Velocity = DeltaSeconds > 0.f ? (Focus - LastTerrainFocus) / DeltaSeconds : FVector::ZeroVector;
+	LastTerrainFocus = Focus;
+	
+	TerrainTracesThisFrame = 0;
+	RequestTerrainTraces(Focus);
+	RequestTerrainTraces(Focus + Velocity * TerrainTraceLookAhead);
+
+	// Without cached heights keep the last offset rather than wait on a trace.
+	float GroundHeight = 0.f;
+	if(TerrainHeightField.SampleHeight(Focus, GroundHeight))
+	{
+		TargetTerrainHeightOffset = GroundHeight - Focus.Z;
+	}
+
+	SET_FLOAT_STAT(STAT_CRPGCamera_TerrainCacheHitRate, TerrainHeightField.GetHitRate() * 100.f);
+	CSV_CUSTOM_STAT(CRPGCamera, TerrainCacheHitRate, TerrainHeightField.GetHitRate(), ECsvCustomStatOp::Set);
+
+	const float NewTerrainHeightOffset = FMath::FInterpTo(TerrainHeightOffset, TargetTerrainHeightOffset, DeltaSeconds, TerrainHeightInterpSpeed);
+	if(!FMath::IsNearlyEqual(NewTerrainHeightOffset, TerrainHeightOffset))
+	{
+		TerrainHeightOffset = NewTerrainHeightOffset;
+		SetCameraTransformAlongSpline(ZoomPercent);
+	}
+}
+
+void ACRPG_PlayerCamera::RequestTerrainTraces(const FVector& Location)
+{
+	UWorld* World = GetWorld();
+	const FIntPoint Cell = TerrainHeightField.GetCell(Location);
+
+	// The 2 x 2 points SampleHeight reads plus a ring around them, so small moves stay inside traced points.
+	for (int32 OffsetY = -1; OffsetY <= 2; ++OffsetY)
+	{
+		for (int32 OffsetX = -1; OffsetX <= 2; ++OffsetX)
+		{
+			const FIntPoint Point = Cell + FIntPoint(OffsetX, OffsetY);
+			if(!TerrainHeightField.NeedsTrace(Point))
+			{
+				continue;
+			}
+
+			if(TerrainTracesThisFrame >= MaxTerrainTracesPerFrame)
+			{
+				return;
+			}
+
+			const FVector2D PointLocation = TerrainHeightField.GetPointLocation(Point);
+			const FVector Start(PointLocation, TerrainCacheZ + TerrainTraceUp);
+			const FVector End(PointLocation, TerrainCacheZ - TerrainTraceDown);
+
+			// The generation rides along as user data so results traced before a reset can be told apart.
+			FCollisionQueryParams Params(SCENE_QUERY_STAT(CRPGCameraTerrain), false, this);
+			World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Start, End, FCollisionObjectQueryParams(TerrainObjectType), Params, &TerrainTraceDelegate, TerrainHeightField.GetGeneration());
+			
+			TerrainHeightField.MarkPending(Point);
+			++TerrainTracesThisFrame;
+			INC_DWORD_STAT(STAT_CRPGCamera_TerrainTraces);
+		}
+	}
+}
+
+void ACRPG_PlayerCamera::OnTerrainTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	TOptional<float> Height;
+	if(!TraceDatum.OutHits.IsEmpty() && TraceDatum.OutHits[0].bBlockingHit)
+	{
+		Height = static_cast<float>(TraceDatum.OutHits[0].ImpactPoint.Z);
+	}
+
+	TerrainHeightField.Store(TerrainHeightField.GetNearestPoint(TraceDatum.Start), TraceDatum.UserData, Height);
+}
+
+/* --------------------------------------------- END: Terrain ------------------------------------------------------- */
+
+/* --------------------------------------------- BEGIN: Move To Location -------------------------------------------- */
+
+void ACRPG_PlayerCamera::MoveTo(const FTransform Destination)
+{
+	// Clear off network smoothing for any previous moves.
+	bPositionCorrected = false;
+	bRotationCorrected = false;
+	MoveHistory.Reset();
+	
+	CameraStart = GetActorTransform();
+	CameraDestination = Destination;
+	CameraDestination.SetLocation(ClampToCameraBounds(CameraStart.GetLocation(), Destination.GetLocation()));
+		
+	float Distance = FVector::Distance(CameraStart.GetLocation(), CameraDestination.GetLocation());
+	TotalDuration = FMath::GetMappedRangeValueClamped(FVector2D(0.0f, MaxMoveToDestinationBeforeMaxSpeed), FVector2D(MinMoveToDuration, MaxMoveToDuration), Distance);
+	CurrentTime = 0.f;		
+	
+	bMovingToDestination = true;
+
+	UE_TRACE_LOG(CRPGCamera, CameraMoveTo, CRPGCameraChannel)
+		<< CameraMoveTo.Cycle(FPlatformTime::Cycles64())
+		<< CameraMoveTo.CameraId(GetUniqueID())
+		<< CameraMoveTo.bStart(true)
+		<< CameraMoveTo.Duration(TotalDuration);
+	
+	if(!HasAuthority())
+	{
+		SERVER_MoveTo(Destination);
+	}
+	else
+	{
+		MoveToDescriptor.Start.SetTransform(CameraStart);
+		MoveToDescriptor.Destination.SetTransform(CameraDestination);
+		MoveToDescriptor.Target = bIsFollowingTarget ? TargetToFollow : nullptr;
+		MoveToDescriptor.Group.Reset();
+		if(bIsFollowingTarget)
+		{
+			MoveToDescriptor.Group = GroupToFollow;
+		}
+		MoveToDescriptor.StartServerTime = GetServerWorldTimeSeconds();
+		MoveToDescriptor.Duration = TotalDuration;
+		MoveToDescriptor.bActive = true;
+		MarkNetActive();
+	}
+
+	UpdateTickEnabled();
+}
+
+void ACRPG_PlayerCamera::SERVER_MoveTo_Implementation(const FTransform Destination)
+{
+	MoveTo(Destination);
+}
+
+void ACRPG_PlayerCamera::StopMoveTo()
+{
+	UE_TRACE_LOG(CRPGCamera, CameraMoveTo, CRPGCameraChannel)
+		<< CameraMoveTo.Cycle(FPlatformTime::Cycles64())
+		<< CameraMoveTo.CameraId(GetUniqueID())
+		<< CameraMoveTo.bStart(false)
+		<< CameraMoveTo.Duration(CurrentTime);
+	
+	bMovingToDestination = false;
+	
+	if(!HasAuthority())
+	{
+		SERVER_StopMoveTo();
+	}
+	else if(MoveToDescriptor.bActive)
+	{
+		UpdateReplicatedState();
+		MoveToDescriptor.bActive = false;
+	}
+
+	UpdateTickEnabled();
+}
+
+void ACRPG_PlayerCamera::SERVER_StopMoveTo_Implementation()
+{
+	StopMoveTo();
+}
+
+void ACRPG_PlayerCamera::MoveToDestination(float DeltaSeconds)
+{
+	if(!bMovingToDestination)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_MoveToDestination);
+	
+	CurrentTime += DeltaSeconds;
+
+	// Smooth the in and out of the move to.
+	const float Alpha = CameraSimulation::EaseInOutCubic(FMath::Clamp(CurrentTime / TotalDuration, 0.0f, 1.0f));
+
+	FTransform NewTransform = FTransform::Identity;
+	NewTransform.SetLocation(FMath::Lerp(CameraStart.GetLocation(), CameraDestination.GetLocation(), Alpha));
+	if(bRotationBlocked)
+	{		
+		NewTransform.SetRotation(FQuat::Slerp(CameraStart.GetRotation(), CameraDestination.GetRotation(), Alpha));
+		SetActorTransform(NewTransform);
+	}
+	else
+	{
+		SetActorLocation(NewTransform.GetLocation());
+	}
+
+	if (Alpha >= 1.0f && !IsFollowingTarget())
+	{
+		if(CameraNetRole != ECameraNetRole::Simulated)
+		{
+			StopMoveTo();
+		}
+		else
+		{
+			bMovingToDestination = false;
+		}
+	}
+}
+
+void ACRPG_PlayerCamera::OnRep_MoveToDescriptor()
+{
+	if(!MoveToDescriptor.bActive)
+	{
+		bMovingToDestination = false;
+		SetTargetToFollow(nullptr);
+
+		// Settle on the server's final state, snapshots from before the move no longer apply.
+		SnapshotBuffer.Reset();
+		ApplyNetState(ReplicatedState);
+		UpdateTickEnabled();
+		return;
+	}
+
+	CameraStart = MoveToDescriptor.Start.GetTransform();
+	CameraDestination = MoveToDescriptor.Destination.GetTransform();
+	TotalDuration = MoveToDescriptor.Duration;
+
+	// Catch up with the time the move has already been running on the server.
+	CurrentTime = FMath::Max(static_cast<float>(GetServerWorldTimeSeconds() - MoveToDescriptor.StartServerTime), 0.f);
+
+	if(MoveToDescriptor.Group.IsEmpty())
+	{
+		SetTargetToFollow(MoveToDescriptor.Target.Get());
+	}
+	else
+	{
+		SetGroupToFollow(MoveToDescriptor.Group);
+	}
+	
+	bMovingToDestination = true;
+	SnapshotBuffer.Reset();
+	UpdateTickEnabled();
+}
+
+double ACRPG_PlayerCamera::GetServerWorldTimeSeconds() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return IsValid(GameState) ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+/* --------------------------------------------- END: Move To Location ---------------------------------------------- */
+
+/* --------------------------------------------- BEGIN: Follow Target ----------------------------------------------- */
+
+void ACRPG_PlayerCamera::FollowTarget(AActor* ActorToFollow, bool bLockRotation /* = false */)
 {
 	if(!IsValid(ActorToFollow) || IsFollowingTarget(ActorToFollow))
 	{
 		return;
 	}
 
-	if(TargetToFollow.IsValid())
+	if(TargetToFollow.IsValid() || IsFollowingGroup())
 	{
 		StopFollowTarget();
 	}
 
 	bRotationBlocked = bLockRotation;
-	TargetToFollow = ActorToFollow;
-	bIsFollowingTarget = true;
-	MoveTo(TargetToFollow->GetActorTransform());
+	SetTargetToFollow(ActorToFollow);
+	MoveTo(ActorToFollow->GetActorTransform());
 }
 
 void ACRPG_PlayerCamera::StopFollowTarget()
 {
 	bRotationBlocked = false;
-	bIsFollowingTarget = false;
-	TargetToFollow = nullptr;
+	SetTargetToFollow(nullptr);
+
+	// Let remote cameras finish the move on the last destination instead of the target.
+	if(HasAuthority() && (MoveToDescriptor.Target.IsValid() || !MoveToDescriptor.Group.IsEmpty()))
+	{
+		MoveToDescriptor.Destination.SetTransform(CameraDestination);
+		MoveToDescriptor.Target = nullptr;
+		MoveToDescriptor.Group.Reset();
+	}
+
+	if(HasAuthority())
+	{
+		MarkNetActive();
+	}
 }
 
 void ACRPG_PlayerCamera::TickFollowTarget(float DeltaTime)
 {
-	if(TargetToFollow.IsValid())
+	// Read the transform every camera following this target shares.
+	const UCRPG_TrackedActorSubsystem* TrackedActorSubsystem = GetWorld()->GetSubsystem<UCRPG_TrackedActorSubsystem>();
+	if(IsValid(TrackedActorSubsystem) && TrackedActorSubsystem->IsTracked(FollowTargetHandle))
 	{
-		CameraDestination = TargetToFollow->GetActorTransform();
+		CameraDestination = TrackedActorSubsystem->GetTransform(FollowTargetHandle);
+		CameraDestination.AddToTranslation(TrackedActorSubsystem->GetVelocity(FollowTargetHandle) * FollowVelocityLead);
+		CameraDestination.SetLocation(ClampToCameraBounds(GetActorLocation(), CameraDestination.GetLocation()));
 	}
 	else
 	{
@@ -521,4 +1303,361 @@ void ACRPG_PlayerCamera::TickFollowTarget(float DeltaTime)
 	}
 }
 
-/* --------------------------------------------- END: Follow Target ------------------------------------------------- */
\ No newline at end of file
+void ACRPG_PlayerCamera::FollowGroup(const TArray<AActor*>& ActorsToFollow, bool bLockRotation /* = false */)
+{
+	TArray<TWeakObjectPtr<AActor>> NewGroup;
+	NewGroup.Reserve(ActorsToFollow.Num());
+	for (AActor* Actor : ActorsToFollow)
+	{
+		if(IsValid(Actor))
+		{
+			NewGroup.Add(Actor);
+		}
+	}
+
+	if(NewGroup.IsEmpty())
+	{
+		return;
+	}
+
+	if(IsFollowingTarget())
+	{
+		StopFollowTarget();
+	}
+
+	bRotationBlocked = bLockRotation;
+	SetGroupToFollow(NewGroup);
+
+	// Start towards the group's current centroid, TickFollowGroup keeps the destination on it from then on.
+	FVector Centroid = FVector::ZeroVector;
+	for (const TWeakObjectPtr<AActor>& Actor : NewGroup)
+	{
+		Centroid += Actor->GetActorLocation();
+	}
+	
+	MoveTo(FTransform(GetActorRotation(), Centroid / NewGroup.Num()));
+}
+
+void ACRPG_PlayerCamera::TickFollowGroup(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCamera_FollowGroup);
+	
+	const UCRPG_TrackedActorSubsystem* TrackedActorSubsystem = GetWorld()->GetSubsystem<UCRPG_TrackedActorSubsystem>();
+	if(!IsValid(TrackedActorSubsystem))
+	{
+		bIsFollowingTarget = false;
+		return;
+	}
+
+	// Gather relative to the camera so the float lanes keep their precision far from the world origin.
+	const FVector Origin = GetActorLocation();
+	FVector Velocity = FVector::ZeroVector;
+	
+	GroupPositions.Reset(GroupHandles.Num());
+	for (const int32 Handle : GroupHandles)
+	{
+		if(TrackedActorSubsystem->IsTracked(Handle))
+		{
+			GroupPositions.Emplace(FVector3f(TrackedActorSubsystem->GetTransform(Handle).GetLocation() - Origin), 0.f);
+			Velocity += TrackedActorSubsystem->GetVelocity(Handle);
+		}
+	}
+
+	if(GroupPositions.IsEmpty())
+	{
+		bIsFollowingTarget = false;
+		return;
+	}
+
+	const FCameraGroupBounds Bounds = CameraFraming::ComputeBounds(GroupPositions);
+	
+	CameraDestination.SetRotation(GetActorQuat());
+	CameraDestination.SetLocation(ClampToCameraBounds(Origin, Origin + FVector(Bounds.Centroid) + Velocity / GroupPositions.Num() * FollowVelocityLead));
+
+	// Only the machine that owns zoom frames the group, everyone else receives its zoom as usual.
+	const bool bOwnsZoom = bClientAuthoritativeZoom ? IsLocallyControlledCamera() : HasAuthority();
+	if(!bOwnsZoom || !ZoomTable.IsBaked() || !IsValid(CameraComponent) || !IsValid(SpringArmComponent))
+	{
+		return;
+	}
+
+	// Distance at which the camera's horizontal field of view covers the group's radius.
+	const float Radius = Bounds.GetPlanarRadius(Bounds.Centroid) * GroupFramingMargin;
+	const float HalfFieldOfView = FMath::DegreesToRadians(FMath::Clamp(CameraComponent->FieldOfView, 1.f, 170.f) * 0.5f);
+	const float FitDistance = Radius / FMath::Tan(HalfFieldOfView) - SpringArmComponent->TargetArmLength;
+	
+	const float FitZoomPercent = ZoomTable.FindZoomPercentForDistance(FitDistance);
+	const float NewZoomPercent = FMath::FInterpTo(ZoomPercent, FitZoomPercent, DeltaTime, GroupZoomInterpSpeed);
+	if(FMath::IsNearlyEqual(NewZoomPercent, ZoomPercent))
+	{
+		return;
+	}
+	
+	ZoomPercent = NewZoomPercent;
+	SetCameraTransformAlongSpline(ZoomPercent);
+
+	if(CameraNetRole == ECameraNetRole::Owner)
+	{
+		SendZoomSnapshot();
+		return;
+	}
+
+	// Compare quantized so the server replicates no more zoom changes than a snapshot could carry.
+	FCameraNetState ZoomState;
+	ZoomState.SetZoomPercent(ZoomPercent);
+	if(ZoomState != LastZoomSnapshot)
+	{
+		LastZoomSnapshot = ZoomState;
+		ReplicateZoom();
+	}
+}
+
+void ACRPG_PlayerCamera::SetTargetToFollow(AActor* NewTarget)
+{
+	ReleaseFollowHandles();
+	
+	TargetToFollow = NewTarget;
+	bIsFollowingTarget = IsValid(NewTarget);
+
+	UCRPG_TrackedActorSubsystem* TrackedActorSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCRPG_TrackedActorSubsystem>() : nullptr;
+	if(bIsFollowingTarget && IsValid(TrackedActorSubsystem))
+	{
+		FollowTargetHandle = TrackedActorSubsystem->Register(NewTarget);
+	}
+}
+
+void ACRPG_PlayerCamera::SetGroupToFollow(const TArray<TWeakObjectPtr<AActor>>& NewGroup)
+{
+	ReleaseFollowHandles();
+
+	TargetToFollow = nullptr;
+	GroupToFollow = NewGroup;
+	bIsFollowingTarget = !GroupToFollow.IsEmpty();
+
+	UCRPG_TrackedActorSubsystem* TrackedActorSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCRPG_TrackedActorSubsystem>() : nullptr;
+	if(!IsValid(TrackedActorSubsystem))
+	{
+		return;
+	}
+	
+	GroupHandles.Reserve(GroupToFollow.Num());
+	for (const TWeakObjectPtr<AActor>& Actor : GroupToFollow)
+	{
+		const int32 Handle = TrackedActorSubsystem->Register(Actor.Get());
+		if(Handle != INDEX_NONE)
+		{
+			GroupHandles.Add(Handle);
+		}
+	}
+}
+
+void ACRPG_PlayerCamera::ReleaseFollowHandles()
+{
+	if(UCRPG_TrackedActorSubsystem* TrackedActorSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCRPG_TrackedActorSubsystem>() : nullptr)
+	{
+		TrackedActorSubsystem->Unregister(FollowTargetHandle);
+		for (const int32 Handle : GroupHandles)
+		{
+			TrackedActorSubsystem->Unregister(Handle);
+		}
+	}
+
+	FollowTargetHandle = INDEX_NONE;
+	GroupToFollow.Reset();
+	GroupHandles.Reset();
+}
+
+/* --------------------------------------------- END: Follow Target ------------------------------------------------- */
+
+/* --------------------------------------------- BEGIN: Commands ---------------------------------------------------- */
+
+void ACRPG_PlayerCamera::PlayCameraCommands(const TArray<FCameraCommand>& Commands)
+{
+	if(Commands.IsEmpty())
+	{
+		return;
+	}
+	
+	if(!HasAuthority())
+	{
+		SERVER_PlayCameraCommands(Commands);
+		return;
+	}
+
+	// A sequence replaces whatever the camera was doing.
+	if(IsFollowingTarget())
+	{
+		StopFollowTarget();
+	}
+
+	if(bMovingToDestination)
+	{
+		StopMoveTo();
+	}
+
+	CameraCommandSchedule.Commands = Commands;
+	CameraCommandSchedule.Commands.SetNum(FMath::Min(Commands.Num(), MaxCameraCommands));
+	CameraCommandSchedule.StartServerTime = GetServerWorldTimeSeconds() + CameraCommandStartDelay;
+	CameraCommandSchedule.bActive = true;
+
+	UE_LOG(LogCRPGPlayerCamera, Verbose, TEXT("%s: Playing %d camera commands over %.2f seconds."), *GetName(), CameraCommandSchedule.Commands.Num(), CameraCommandSchedule.GetDuration());
+
+	BeginCameraCommands();
+	MarkNetActive();
+}
+
+void ACRPG_PlayerCamera::SERVER_PlayCameraCommands_Implementation(const TArray<FCameraCommand>& Commands)
+{
+	PlayCameraCommands(Commands);
+}
+
+bool ACRPG_PlayerCamera::SERVER_PlayCameraCommands_Validate(const TArray<FCameraCommand>& Commands)
+{
+	return Commands.Num() <= MaxCameraCommands && Algo::AllOf(Commands, [](const FCameraCommand& Command)
+	{
+		return Command.IsValid();
+	});
+}
+
+void ACRPG_PlayerCamera::StopCameraCommands()
+{
+	if(!HasAuthority())
+	{
+		SERVER_StopCameraCommands();
+		return;
+	}
+
+	EndCameraCommands();
+}
+
+void ACRPG_PlayerCamera::SERVER_StopCameraCommands_Implementation()
+{
+	StopCameraCommands();
+}
+
+void ACRPG_PlayerCamera::OnRep_CameraCommandSchedule()
+{
+	if(CameraCommandSchedule.bActive)
+	{
+		BeginCameraCommands();
+		return;
+	}
+
+	EndCameraCommands();
+
+	// Settle on the server's final state, like the end of a MoveTo.
+	if(CameraNetRole == ECameraNetRole::Simulated)
+	{
+		SnapshotBuffer.Reset();
+		ApplyNetState(ReplicatedState);
+	}
+}
+
+void ACRPG_PlayerCamera::TickCameraCommands()
+{
+	const TArray<FCameraCommand>& Commands = CameraCommandSchedule.Commands;
+	const double ScheduleTime = GetServerWorldTimeSeconds() - CameraCommandSchedule.StartServerTime;
+
+	// Finish every step that has ended, a hitch or a late start can pass several in one frame.
+	while(Commands.IsValidIndex(CameraCommandIndex)
+		&& ScheduleTime >= CameraCommandStepStartTime + FMath::Max(Commands[CameraCommandIndex].Duration, 0.f))
+	{
+		ApplyCameraCommand(Commands[CameraCommandIndex], 1.f);
+		CameraCommandStepStartTime += FMath::Max(Commands[CameraCommandIndex].Duration, 0.f);
+		++CameraCommandIndex;
+		BeginCameraCommandStep();
+	}
+
+	if(!Commands.IsValidIndex(CameraCommandIndex))
+	{
+		EndCameraCommands();
+		return;
+	}
+
+	const FCameraCommand& Command = Commands[CameraCommandIndex];
+	const float Alpha = Command.Duration > 0.f ? static_cast<float>((ScheduleTime - CameraCommandStepStartTime) / Command.Duration) : 0.f;
+	
+	ApplyCameraCommand(Command, Alpha);
+}
+
+void ACRPG_PlayerCamera::BeginCameraCommands()
+{
+	bMovingToDestination = false;
+	SetTargetToFollow(nullptr);
+	SnapshotBuffer.Reset();
+
+	CameraCommandIndex = 0;
+	CameraCommandStepStartTime = 0.0;
+	BeginCameraCommandStep();
+	
+	UpdateTickEnabled();
+}
+
+void ACRPG_PlayerCamera::EndCameraCommands()
+{
+	CameraCommandIndex = INDEX_NONE;
+
+	// Remote machines hold the final pose until the server ends the schedule.
+	if(HasAuthority() && CameraCommandSchedule.bActive)
+	{
+		CameraCommandSchedule.bActive = false;
+		UpdateReplicatedState();
+		ReplicateZoom();
+		MarkNetActive();
+	}
+
+	UpdateTickEnabled();
+}
+
+void ACRPG_PlayerCamera::BeginCameraCommandStep()
+{
+	CameraCommandStartTransform = GetActorTransform();
+	CameraCommandStartZoomPercent = ZoomPercent;
+}
+
+void ACRPG_PlayerCamera::ApplyCameraCommand(const FCameraCommand& Command, float Alpha)
+{
+	const float EasedAlpha = CameraEasing::Evaluate(Command.Easing, Alpha);
+
+	switch (Command.Type)
+	{
+	case ECameraCommandType::MoveTo:
+		{
+			// Clamped like MoveTo, so a sequence can't take the camera out of bounds either.
+			const FVector Location = Command.State.HasLocation()
+				? ClampToCameraBounds(CameraCommandStartTransform.GetLocation(), FMath::Lerp(CameraCommandStartTransform.GetLocation(), Command.State.GetLocation(), EasedAlpha))
+				: CameraCommandStartTransform.GetLocation();
+
+			FQuat Rotation = CameraCommandStartTransform.GetRotation();
+			if(Command.State.HasYaw())
+			{
+				const FRotator StartRotation = CameraCommandStartTransform.Rotator();
+				const FRotator DestinationRotation(StartRotation.Pitch, Command.State.GetYaw(), StartRotation.Roll);
+				Rotation = FQuat::Slerp(Rotation, DestinationRotation.Quaternion(), EasedAlpha);
+			}
+
+			SetActorLocationAndRotation(Location, Rotation);
+			break;
+		}
+		
+	case ECameraCommandType::Follow:
+		if(Command.Target.IsValid())
+		{
+			SetActorLocation(ClampToCameraBounds(CameraCommandStartTransform.GetLocation(), FMath::Lerp(CameraCommandStartTransform.GetLocation(), Command.Target->GetActorLocation(), EasedAlpha)));
+		}
+		break;
+		
+	case ECameraCommandType::Zoom:
+		if(Command.State.HasZoomPercent())
+		{
+			ZoomPercent = FMath::Lerp(CameraCommandStartZoomPercent, Command.State.GetZoomPercent(), EasedAlpha);
+			SetCameraTransformAlongSpline(ZoomPercent);
+		}
+		break;
+		
+	case ECameraCommandType::Hold:
+		break;
+	}
+}
+
+/* --------------------------------------------- END: Commands ------------------------------------------------------ */
\ No newline at end of file
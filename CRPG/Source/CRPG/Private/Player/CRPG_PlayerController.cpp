@@ -4,8 +4,13 @@
 #include "Player/CRPG_PlayerController.h"
 
 // CRPG
+#include "Characters/CRPG_BaseCharacter.h"
+#include "Game/CRPG_PartyMovementSubsystem.h"
+#include "Game/CRPG_SelectableActorSubsystem.h"
 #include "Player/CRPG_PlayerCamera.h"
 #include "Player/Input/CRPG_TacticalInputDataAsset.h"
+#include "Player/Selection/CRPG_CursorHitService.h"
+#include "Player/Selection/CRPG_SelectionFrustum.h"
 
 // Unreal
 #include "EnhancedInputComponent.h"
@@ -17,12 +22,20 @@ DEFINE_LOG_CATEGORY(LogCRPGPlayerController);
 ACRPG_PlayerController::ACRPG_PlayerController()
 {
 	bReplicates = true;
-	bAlwaysRelevant = true;
+
+	// Player controllers are only relevant to their owner, being always relevant only adds them to every connection's consider list.
+	bAlwaysRelevant = false;
 
 	// This is the default set up and would force classic CRPG movement.
 	bUsingTactical = true;
 	bIsLockedToTarget = false;
 	bBlockingCameraInput = false;
+	bSelectPressed = false;
+	bMarqueeActive = false;
+	MarqueeStart = FVector2D::ZeroVector;
+	MarqueeEnd = FVector2D::ZeroVector;
+
+	CursorHitService = CreateDefaultSubobject<UCRPG_CursorHitService>("CursorHitService");
 }
 
 void ACRPG_PlayerController::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -52,6 +65,9 @@ void ACRPG_PlayerController::SetupInputComponent()
 		EnhancedInputComponent->BindAction(TacticalInputDataAsset->GetRotateCamera(), ETriggerEvent::Triggered, this, &ACRPG_PlayerController::CameraRotateInput);
 		EnhancedInputComponent->BindAction(TacticalInputDataAsset->GetZoomCamera(), ETriggerEvent::Triggered, this, &ACRPG_PlayerController::CameraZoomInput);
 		EnhancedInputComponent->BindAction(TacticalInputDataAsset->GetLockCameraToCharacter(), ETriggerEvent::Started, this, &ACRPG_PlayerController::CameraLockInput);
+		EnhancedInputComponent->BindAction(TacticalInputDataAsset->GetSelect(), ETriggerEvent::Started, this, &ACRPG_PlayerController::SelectInput);
+		EnhancedInputComponent->BindAction(TacticalInputDataAsset->GetSelect(), ETriggerEvent::Completed, this, &ACRPG_PlayerController::SelectReleasedInput);
+		EnhancedInputComponent->BindAction(TacticalInputDataAsset->GetMoveSelected(), ETriggerEvent::Started, this, &ACRPG_PlayerController::MoveSelectedInput);
 	}
 }
 
@@ -140,6 +156,25 @@ void ACRPG_PlayerController::CameraLockInput(const FInputActionValue& Input)
 	}
 }
 
+void ACRPG_PlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	// Input for this frame has been processed, send it to the camera as a single command.
+	if(IsValid(PlayerCamera))
+	{
+		PlayerCamera->FlushCameraInput(DeltaTime);
+		PlayerCamera->TickTerrainFollow(DeltaTime);
+	}
+
+	if(IsValid(CursorHitService))
+	{
+		CursorHitService->Update();
+	}
+
+	TickMarquee();
+}
+
 /* ------------------------------------------------ END: Camera Input ----------------------------------------------- */
 
 /* ------------------------------------------------ BEGIN: Camera Setup --------------------------------------------- */
@@ -149,6 +184,16 @@ void ACRPG_PlayerController::AutoManageActiveCameraTarget(AActor* SuggestedTarge
 	SetPlayerCamera();
 }
 
+void ACRPG_PlayerController::GetPlayerViewPoint(FVector& OutLocation, FRotator& OutRotation) const
+{
+	Super::GetPlayerViewPoint(OutLocation, OutRotation);
+
+	if(IsValid(PlayerCamera) && !IsLocalController())
+	{
+		OutLocation = PlayerCamera->GetActorLocation();
+	}
+}
+
 void ACRPG_PlayerController::SetPlayerCamera()
 {
 	if(IsValid(GetWorld()) && IsValid(GetPawn()) && !IsValid(PlayerCamera) && PlayerCameraToSpawn)
@@ -223,6 +268,24 @@ void ACRPG_PlayerController::LockCameraToTarget(AActor* ActorToTarget, bool bTar
 	}
 }
 
+void ACRPG_PlayerController::LockCameraToGroup(const TArray<AActor*>& ActorsToTarget, bool bTargetBlocksCameraInput)
+{
+	if(ActorsToTarget.IsEmpty() || !IsValid(PlayerCamera))
+	{
+		return;
+	}
+
+	bIsLockedToTarget = true;
+	bBlockingCameraInput = bTargetBlocksCameraInput;
+
+	PlayerCamera->FollowGroup(ActorsToTarget);
+	
+	if(!HasAuthority())
+	{				
+		SERVER_LockCameraToGroup(ActorsToTarget, bTargetBlocksCameraInput);
+	}
+}
+
 void ACRPG_PlayerController::UnlockCamera(bool bUnblockCameraInput)
 {
 	if(!IsValid(PlayerCamera))
@@ -247,9 +310,227 @@ void ACRPG_PlayerController::SERVER_LockCameraToTarget_Implementation(AActor* Ac
 	LockCameraToTarget(ActorToTarget, bTargetBlocksCameraInput);
 }
 
+void ACRPG_PlayerController::SERVER_LockCameraToGroup_Implementation(const TArray<AActor*>& ActorsToTarget, bool bTargetBlocksCameraInput)
+{
+	LockCameraToGroup(ActorsToTarget, bTargetBlocksCameraInput);
+}
+
 void ACRPG_PlayerController::SERVER_UnlockCamera_Implementation(bool bUnblockCameraInput)
 {
 	UnlockCamera(bUnblockCameraInput);
 }
 
 /* ------------------------------------------------ END: Camera Attachment ------------------------------------------ */
+
+/* ------------------------------------------------ BEGIN: Selection ------------------------------------------------ */
+
+void ACRPG_PlayerController::SelectInput(const FInputActionValue& Input)
+{
+	float MouseX;
+	float MouseY;
+	if(!GetMousePosition(MouseX, MouseY))
+	{
+		return;
+	}
+
+	// Whether this is a click or a marquee is only known once the cursor moves or the button is released.
+	bSelectPressed = true;
+	bMarqueeActive = false;
+	MarqueeStart = FVector2D(MouseX, MouseY);
+	MarqueeEnd = MarqueeStart;
+	MarqueeActors.Reset();
+}
+
+void ACRPG_PlayerController::SelectReleasedInput(const FInputActionValue& Input)
+{
+	if(!bSelectPressed)
+	{
+		return;
+	}
+
+	bSelectPressed = false;
+	SelectedActors.Reset();
+
+	if(bMarqueeActive)
+	{
+		bMarqueeActive = false;
+
+		// Anything destroyed since the last marquee update is dropped.
+		for (const TWeakObjectPtr<AActor>& Actor : MarqueeActors)
+		{
+			if(Actor.IsValid())
+			{
+				SelectedActors.Add(Actor);
+			}
+		}
+
+		MarqueeActors.Reset();
+		return;
+	}
+
+	if(!IsValid(CursorHitService))
+	{
+		return;
+	}
+	
+	if(AActor* Selectable = CursorHitService->GetHit().Selectable.Get())
+	{
+		SelectedActors.Add(Selectable);
+	}
+}
+
+void ACRPG_PlayerController::TickMarquee()
+{
+	if(!bSelectPressed)
+	{
+		return;
+	}
+
+	float MouseX;
+	float MouseY;
+	if(!GetMousePosition(MouseX, MouseY))
+	{
+		return;
+	}
+
+	MarqueeEnd = FVector2D(MouseX, MouseY);
+
+	if(!bMarqueeActive)
+	{
+		if(FVector2D::DistSquared(MarqueeStart, MarqueeEnd) < FMath::Square(MarqueeDragThreshold))
+		{
+			return;
+		}
+		
+		bMarqueeActive = true;
+	}
+
+	MarqueeActors.Reset();
+
+	const UCRPG_SelectableActorSubsystem* Selectables = GetWorld()->GetSubsystem<UCRPG_SelectableActorSubsystem>();
+	if(!Selectables)
+	{
+		return;
+	}
+
+	// The view is the player camera's, so the frustum matches what the player sees inside the rectangle.
+	FSelectionFrustum Frustum;
+	if(FSelectionFrustum::FromScreenRect(*this, MarqueeStart, MarqueeEnd, Frustum))
+	{
+		Selectables->FindInFrustum(Frustum, MarqueeActors);
+	}
+}
+
+bool ACRPG_PlayerController::GetMarqueeRect(FVector2D& OutMin, FVector2D& OutMax) const
+{
+	if(!bMarqueeActive)
+	{
+		return false;
+	}
+
+	OutMin = FVector2D::Min(MarqueeStart, MarqueeEnd);
+	OutMax = FVector2D::Max(MarqueeStart, MarqueeEnd);
+	return true;
+}
+
+/* ------------------------------------------------ END: Selection -------------------------------------------------- */
+
+/* ------------------------------------------------ BEGIN: Party Movement ------------------------------------------- */
+
+void ACRPG_PlayerController::MoveSelectedInput(const FInputActionValue& Input)
+{
+	if(!IsValid(CursorHitService) || !CursorHitService->GetHit().bHit)
+	{
+		return;
+	}
+
+	MoveSelectedActorsTo(CursorHitService->GetHit().Hit.Location);
+}
+
+void ACRPG_PlayerController::MoveSelectedActorsTo(const FVector& Destination)
+{
+	TArray<APawn*> Members;
+	for (const TWeakObjectPtr<AActor>& SelectedActor : SelectedActors)
+	{
+		if(APawn* Member = Cast<APawn>(SelectedActor.Get()))
+		{
+			Members.Add(Member);
+		}
+	}
+
+	MovePartyTo(Members, Destination);
+}
+
+void ACRPG_PlayerController::MovePartyTo(const TArray<APawn*>& Members, const FVector& Destination)
+{
+	if(Members.IsEmpty())
+	{
+		return;
+	}
+
+	// The same check on every path, so a listen server's host can't order other players' members either. Clients only
+	// send what the server accepts, an oversized order would get them kicked.
+	TArray<APawn*> OrderedMembers;
+	for (APawn* Member : Members)
+	{
+		if(CanOrderMember(Member) && (HasAuthority() || OrderedMembers.Num() < MaxPartyOrderMembers))
+		{
+			OrderedMembers.Add(Member);
+		}
+	}
+
+	if(OrderedMembers.IsEmpty())
+	{
+		return;
+	}
+
+	if(!HasAuthority())
+	{
+		SERVER_MovePartyTo(OrderedMembers, Destination);
+		return;
+	}
+
+	if(UCRPG_PartyMovementSubsystem* PartyMovementSubsystem = GetWorld()->GetSubsystem<UCRPG_PartyMovementSubsystem>())
+	{
+		PartyMovementSubsystem->MoveParty(OrderedMembers, Destination);
+	}
+}
+
+bool ACRPG_PlayerController::CanOrderMember(const APawn* Member) const
+{
+	if(!IsValid(Member))
+	{
+		return false;
+	}
+
+	// The pawn this player possesses, whatever party it is in.
+	if(Member->GetController() == this)
+	{
+		return true;
+	}
+
+	// Party members are usually AI controlled, and on clients have no controller at all.
+	const ACRPG_BaseCharacter* Character = Cast<ACRPG_BaseCharacter>(Member);
+	return Character && PlayerState && Character->GetOwningPlayerState() == PlayerState;
+}
+
+void ACRPG_PlayerController::SERVER_MovePartyTo_Implementation(const TArray<APawn*>& Members, FVector_NetQuantize Destination)
+{
+	for (const APawn* Member : Members)
+	{
+		if(!CanOrderMember(Member))
+		{
+			UE_LOG(LogCRPGPlayerController, Warning, TEXT("%s: Dropped %s from a party order, it isn't in this player's party."), *GetName(), *GetNameSafe(Member));
+		}
+	}
+
+	// MovePartyTo leaves them out with the same check.
+	MovePartyTo(Members, Destination);
+}
+
+bool ACRPG_PlayerController::SERVER_MovePartyTo_Validate(const TArray<APawn*>& Members, FVector_NetQuantize Destination)
+{
+	return Members.Num() <= MaxPartyOrderMembers;
+}
+
+/* ------------------------------------------------ END: Party Movement --------------------------------------------- */
@@ -0,0 +1,96 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraBoundsAsset.h"
+
+// UE
+#include "GameFramework/Volume.h"
+
+bool UCRPG_CameraBoundsAsset::IsLegal(const FVector& Location) const
+{
+	const int32 X = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+	
+	if(X < 0 || Y < 0 || X >= Dimensions.X || Y >= Dimensions.Y)
+	{
+		return false;
+	}
+
+	const int32 Index = Y * Dimensions.X + X;
+	return (Cells[Index >> 3] & (1 << (Index & 7))) != 0;
+}
+
+FVector UCRPG_CameraBoundsAsset::Clamp(const FVector& From, const FVector& To) const
+{
+	if(!IsBaked() || IsLegal(To) || !IsLegal(From))
+	{
+		return To;
+	}
+
+	const FVector SlideX(To.X, From.Y, To.Z);
+	if(IsLegal(SlideX))
+	{
+		return SlideX;
+	}
+
+	const FVector SlideY(From.X, To.Y, To.Z);
+	if(IsLegal(SlideY))
+	{
+		return SlideY;
+	}
+
+	return FVector(From.X, From.Y, To.Z);
+}
+
+#if WITH_EDITOR
+void UCRPG_CameraBoundsAsset::Bake(TConstArrayView<const AVolume*> Volumes)
+{
+	// Keeps a careless cell size from producing a grid too large to ship.
+	constexpr int32 MaxDimension = 4096;
+	
+	Modify();
+	
+	Origin = FVector2D::ZeroVector;
+	Dimensions = FIntPoint(0, 0);
+	Cells.Reset();
+
+	FBox Bounds(ForceInit);
+	for (const AVolume* Volume : Volumes)
+	{
+		Bounds += Volume->GetComponentsBoundingBox();
+	}
+
+	if(!Bounds.IsValid)
+	{
+		MarkPackageDirty();
+		return;
+	}
+
+	Origin = FVector2D(Bounds.Min);
+	Dimensions.X = FMath::Clamp(FMath::CeilToInt32((Bounds.Max.X - Bounds.Min.X) / CellSize), 1, MaxDimension);
+	Dimensions.Y = FMath::Clamp(FMath::CeilToInt32((Bounds.Max.Y - Bounds.Min.Y) / CellSize), 1, MaxDimension);
+	Cells.SetNumZeroed((Dimensions.X * Dimensions.Y + 7) / 8);
+
+	for (int32 Y = 0; Y < Dimensions.Y; ++Y)
+	{
+		for (int32 X = 0; X < Dimensions.X; ++X)
+		{
+			const FVector2D CellCenter = Origin + (FVector2D(X, Y) + 0.5) * CellSize;
+
+			// The grid is 2D, test each volume at its own height.
+			const bool bLegal = Volumes.ContainsByPredicate([&CellCenter](const AVolume* Volume)
+			{
+				return Volume->EncompassesPoint(FVector(CellCenter, Volume->GetComponentsBoundingBox().GetCenter().Z));
+			});
+
+			if(bLegal)
+			{
+				const int32 Index = Y * Dimensions.X + X;
+				Cells[Index >> 3] |= 1 << (Index & 7);
+			}
+		}
+	}
+
+	MarkPackageDirty();
+}
+#endif
@@ -0,0 +1,40 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraBoundsVolume.h"
+
+// CRPG
+#include "Player/Camera/CRPG_CameraBoundsAsset.h"
+
+// UE
+#include "Components/BrushComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "EngineUtils.h"
+
+ACRPG_CameraBoundsVolume::ACRPG_CameraBoundsVolume()
+{
+	// Only the baked grid is used at runtime, the brush never needs collision.
+	GetBrushComponent()->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	GetBrushComponent()->SetGenerateOverlapEvents(false);
+}
+
+#if WITH_EDITOR
+void ACRPG_CameraBoundsVolume::BakeCameraBounds()
+{
+	if(!IsValid(BoundsAsset))
+	{
+		return;
+	}
+
+	TArray<const AVolume*> Volumes;
+	for (TActorIterator<ACRPG_CameraBoundsVolume> It(GetWorld()); It; ++It)
+	{
+		if(It->BoundsAsset == BoundsAsset)
+		{
+			Volumes.Add(*It);
+		}
+	}
+
+	BoundsAsset->Bake(Volumes);
+}
+#endif
@@ -0,0 +1,78 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraCommand.h"
+
+FCameraCommand FCameraCommand::MakeMoveTo(const FTransform& Destination, float StepDuration, ECameraEasing StepEasing)
+{
+	FCameraCommand Command;
+	Command.Type = ECameraCommandType::MoveTo;
+	Command.Easing = StepEasing;
+	Command.Duration = StepDuration;
+	Command.State.SetTransform(Destination);
+	return Command;
+}
+
+FCameraCommand FCameraCommand::MakeFollow(AActor* ActorToFollow, float StepDuration, ECameraEasing StepEasing)
+{
+	FCameraCommand Command;
+	Command.Type = ECameraCommandType::Follow;
+	Command.Easing = StepEasing;
+	Command.Duration = StepDuration;
+	Command.Target = ActorToFollow;
+	return Command;
+}
+
+FCameraCommand FCameraCommand::MakeZoom(float ZoomPercent, float StepDuration, ECameraEasing StepEasing)
+{
+	FCameraCommand Command;
+	Command.Type = ECameraCommandType::Zoom;
+	Command.Easing = StepEasing;
+	Command.Duration = StepDuration;
+	Command.State.SetZoomPercent(ZoomPercent);
+	return Command;
+}
+
+FCameraCommand FCameraCommand::MakeHold(float StepDuration)
+{
+	FCameraCommand Command;
+	Command.Type = ECameraCommandType::Hold;
+	Command.Duration = StepDuration;
+	return Command;
+}
+
+bool FCameraCommand::IsValid() const
+{
+	if(Type > ECameraCommandType::Hold || Easing > ECameraEasing::CubicInOut)
+	{
+		return false;
+	}
+
+	if(!FMath::IsFinite(Duration) || Duration < 0.f || Duration > MaxDuration)
+	{
+		return false;
+	}
+
+	switch (Type)
+	{
+	case ECameraCommandType::MoveTo:
+		return State.HasLocation() || State.HasYaw();
+		
+	case ECameraCommandType::Zoom:
+		return State.HasZoomPercent();
+		
+	default:
+		return true;
+	}
+}
+
+float FCameraCommandSchedule::GetDuration() const
+{
+	float Duration = 0.f;
+	for (const FCameraCommand& Command : Commands)
+	{
+		Duration += FMath::Max(Command.Duration, 0.f);
+	}
+	
+	return Duration;
+}
@@ -0,0 +1,91 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraFraming.h"
+
+float FCameraGroupBounds::GetPlanarRadius(const FVector3f& Center) const
+{
+	const float ExtentX = FMath::Max(Max.X - Center.X, Center.X - Min.X);
+	const float ExtentY = FMath::Max(Max.Y - Center.Y, Center.Y - Min.Y);
+
+	return FMath::Sqrt(ExtentX * ExtentX + ExtentY * ExtentY);
+}
+
+FCameraGroupBounds CameraFraming::ComputeBounds(TConstArrayView<FVector4f> Positions)
+{
+	FCameraGroupBounds Bounds;
+
+	const int32 NumPositions = Positions.Num();
+	if(NumPositions == 0)
+	{
+		return Bounds;
+	}
+
+	const float* Data = &Positions[0].X;
+	
+	// Two independent accumulators per reduction so consecutive points don't wait on each other's results.
+	VectorRegister4Float Sum0 = VectorZeroFloat();
+	VectorRegister4Float Sum1 = VectorZeroFloat();
+	VectorRegister4Float Min0 = VectorLoad(Data);
+	VectorRegister4Float Min1 = Min0;
+	VectorRegister4Float Max0 = Min0;
+	VectorRegister4Float Max1 = Min0;
+
+	int32 Index = 0;
+	for (; Index + 1 < NumPositions; Index += 2)
+	{
+		const VectorRegister4Float Position0 = VectorLoad(Data + Index * 4);
+		const VectorRegister4Float Position1 = VectorLoad(Data + Index * 4 + 4);
+
+		Sum0 = VectorAdd(Sum0, Position0);
+		Sum1 = VectorAdd(Sum1, Position1);
+		Min0 = VectorMin(Min0, Position0);
+		Min1 = VectorMin(Min1, Position1);
+		Max0 = VectorMax(Max0, Position0);
+		Max1 = VectorMax(Max1, Position1);
+	}
+
+	if(Index < NumPositions)
+	{
+		const VectorRegister4Float Position = VectorLoad(Data + Index * 4);
+		
+		Sum0 = VectorAdd(Sum0, Position);
+		Min0 = VectorMin(Min0, Position);
+		Max0 = VectorMax(Max0, Position);
+	}
+
+	const VectorRegister4Float Centroid = VectorMultiply(VectorAdd(Sum0, Sum1), VectorSetFloat1(1.f / NumPositions));
+	
+	VectorStoreFloat3(Centroid, &Bounds.Centroid.X);
+	VectorStoreFloat3(VectorMin(Min0, Min1), &Bounds.Min.X);
+	VectorStoreFloat3(VectorMax(Max0, Max1), &Bounds.Max.X);
+
+	return Bounds;
+}
+
+FCameraGroupBounds CameraFraming::ComputeBoundsScalar(TConstArrayView<FVector4f> Positions)
+{
+	FCameraGroupBounds Bounds;
+
+	if(Positions.IsEmpty())
+	{
+		return Bounds;
+	}
+
+	FVector3f Sum = FVector3f::ZeroVector;
+	Bounds.Min = FVector3f(Positions[0]);
+	Bounds.Max = Bounds.Min;
+	
+	for (const FVector4f& Position : Positions)
+	{
+		const FVector3f Point(Position);
+		
+		Sum += Point;
+		Bounds.Min = Bounds.Min.ComponentMin(Point);
+		Bounds.Max = Bounds.Max.ComponentMax(Point);
+	}
+
+	Bounds.Centroid = Sum / Positions.Num();
+	
+	return Bounds;
+}
@@ -0,0 +1,124 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraHeightField.h"
+
+void FCameraHeightField::Init(int32 InDimension, float InCellSize)
+{
+	// Needs at least the 2 x 2 points around the focus and the ones ahead of it.
+	Dimension = FMath::Max(InDimension, 4);
+	CellSize = FMath::Max(InCellSize, 1.f);
+	
+	Slots.SetNum(Dimension * Dimension);
+	Reset();
+
+	Hits = 0;
+	Misses = 0;
+}
+
+void FCameraHeightField::Reset()
+{
+	for (FSlot& Slot : Slots)
+	{
+		Slot.State = ESlotState::Empty;
+	}
+	
+	++Generation;
+}
+
+FIntPoint FCameraHeightField::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+FIntPoint FCameraHeightField::GetNearestPoint(const FVector& Location) const
+{
+	return FIntPoint(FMath::RoundToInt32(Location.X / CellSize), FMath::RoundToInt32(Location.Y / CellSize));
+}
+
+bool FCameraHeightField::NeedsTrace(const FIntPoint& Point) const
+{
+	const FSlot& Slot = Slots[GetSlotIndex(Point)];
+	return Slot.State == ESlotState::Empty || Slot.Point != Point;
+}
+
+void FCameraHeightField::MarkPending(const FIntPoint& Point)
+{
+	FSlot& Slot = Slots[GetSlotIndex(Point)];
+	Slot.Point = Point;
+	Slot.Generation = Generation;
+	Slot.State = ESlotState::Pending;
+}
+
+void FCameraHeightField::Store(const FIntPoint& Point, uint32 TraceGeneration, TOptional<float> Height)
+{
+	FSlot& Slot = Slots[GetSlotIndex(Point)];
+	if(Slot.Point != Point || Slot.State != ESlotState::Pending || Slot.Generation != TraceGeneration)
+	{
+		return;
+	}
+
+	Slot.Height = Height.Get(0.f);
+	Slot.State = Height.IsSet() ? ESlotState::Ground : ESlotState::NoGround;
+}
+
+bool FCameraHeightField::SampleHeight(const FVector& Location, float& OutHeight)
+{
+	const FIntPoint Cell = GetCell(Location);
+	const FIntPoint Corners[4] = {Cell, Cell + FIntPoint(1, 0), Cell + FIntPoint(0, 1), Cell + FIntPoint(1, 1)};
+
+	float Heights[4];
+	int32 NumGround = 0;
+	float GroundSum = 0.f;
+	
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		const FSlot& Slot = Slots[GetSlotIndex(Corners[Index])];
+		if(Slot.Point != Corners[Index] || Slot.State == ESlotState::Empty || Slot.State == ESlotState::Pending)
+		{
+			++Misses;
+			return false;
+		}
+
+		Heights[Index] = Slot.Height;
+		if(Slot.State == ESlotState::Ground)
+		{
+			GroundSum += Slot.Height;
+			++NumGround;
+		}
+	}
+
+	++Hits;
+
+	if(NumGround == 0)
+	{
+		return false;
+	}
+
+	// Points without ground, such as over a pit, take the average of the ones around them.
+	if(NumGround < 4)
+	{
+		const float AverageHeight = GroundSum / NumGround;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			if(Slots[GetSlotIndex(Corners[Index])].State == ESlotState::NoGround)
+			{
+				Heights[Index] = AverageHeight;
+			}
+		}
+	}
+
+	const float AlphaX = static_cast<float>(Location.X / CellSize - Cell.X);
+	const float AlphaY = static_cast<float>(Location.Y / CellSize - Cell.Y);
+	
+	OutHeight = FMath::BiLerp(Heights[0], Heights[1], Heights[2], Heights[3], AlphaX, AlphaY);
+	return true;
+}
+
+int32 FCameraHeightField::GetSlotIndex(const FIntPoint& Point) const
+{
+	const int32 X = ((Point.X % Dimension) + Dimension) % Dimension;
+	const int32 Y = ((Point.Y % Dimension) + Dimension) % Dimension;
+	
+	return Y * Dimension + X;
+}
@@ -0,0 +1,214 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraInputCommand.h"
+
+// CRPG
+#include "Player/Camera/CRPG_CameraNetState.h"
+
+namespace CameraInputCommand
+{
+	enum EFlags : uint8
+	{
+		Move = 1 << 0,
+		Yaw = 1 << 1,
+		Zoom = 1 << 2,
+
+		NumBits = 3
+	};
+}
+
+void FCameraInputCommand::SetMove(const FVector2D& Input)
+{
+	MoveX = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Input.X, -1.f, 1.f) * MoveScale));
+	MoveY = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Input.Y, -1.f, 1.f) * MoveScale));
+}
+
+void FCameraInputCommand::SetYaw(float Input)
+{
+	Yaw = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Input * AxisScale), -MAX_int16, MAX_int16));
+}
+
+void FCameraInputCommand::SetZoom(float Input)
+{
+	Zoom = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Input * AxisScale), -MAX_int16, MAX_int16));
+}
+
+void FCameraInputCommand::SetDeltaSeconds(float DeltaSeconds)
+{
+	DeltaTime = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(DeltaSeconds * DeltaTimeScale), 0, MAX_uint16));
+}
+
+bool FCameraInputCommand::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if(Ar.IsLoading())
+	{
+		*this = FCameraInputCommand();
+	}
+
+	// The server resolves the low bits against the last sequence it applied.
+	uint16 SequenceBits = static_cast<uint16>(Sequence & MAX_uint16);
+	Ar << SequenceBits;
+	if(Ar.IsLoading())
+	{
+		Sequence = SequenceBits;
+	}
+
+	SerializePayload(Ar);
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+void FCameraInputCommand::SerializePayload(FArchive& Ar)
+{
+	uint8 Flags = 0;
+	if(Ar.IsSaving())
+	{
+		Flags |= HasMove() ? CameraInputCommand::Move : 0;
+		Flags |= HasYaw() ? CameraInputCommand::Yaw : 0;
+		Flags |= HasZoom() ? CameraInputCommand::Zoom : 0;
+	}
+	Ar.SerializeBits(&Flags, CameraInputCommand::NumBits);
+
+	// Only the axes that carry input are written.
+	if(Flags & CameraInputCommand::Move)
+	{
+		Ar << MoveX;
+		Ar << MoveY;
+	}
+
+	if(Flags & CameraInputCommand::Yaw)
+	{
+		Ar << Yaw;
+	}
+
+	if(Flags & CameraInputCommand::Zoom)
+	{
+		Ar << Zoom;
+	}
+	
+	Ar << DeltaTime;
+}
+
+bool FCameraInputCommandBatch::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 NumCommands = FMath::Min(Commands.Num(), MaxCommands);
+	Ar.SerializeIntPacked(NumCommands);
+
+	if(Ar.IsLoading())
+	{
+		if(NumCommands > static_cast<uint32>(MaxCommands))
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return true;
+		}
+		
+		Commands.SetNum(NumCommands);
+	}
+
+	for (uint32 Index = 0; Index < NumCommands && !Ar.IsError(); ++Index)
+	{
+		FCameraInputCommand& Command = Commands[Index];
+		if(Ar.IsLoading())
+		{
+			Command = FCameraInputCommand();
+		}
+		
+		if(Index == 0)
+		{
+			// The server resolves the low bits against the last sequence it applied.
+			uint16 SequenceBits = static_cast<uint16>(Command.Sequence & MAX_uint16);
+			Ar << SequenceBits;
+			if(Ar.IsLoading())
+			{
+				Command.Sequence = SequenceBits;
+			}
+		}
+		else
+		{
+			const uint32 PreviousSequence = Commands[Index - 1].Sequence;
+
+			uint8 bConsecutive = Command.Sequence == PreviousSequence + 1;
+			Ar.SerializeBits(&bConsecutive, 1);
+
+			uint32 Delta = bConsecutive ? 1 : Command.Sequence - PreviousSequence;
+			if(!bConsecutive)
+			{
+				Ar.SerializeIntPacked(Delta);
+			}
+			
+			if(Ar.IsLoading())
+			{
+				Command.Sequence = PreviousSequence + Delta;
+			}
+		}
+
+		Command.SerializePayload(Ar);
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+void FCameraInputTimeBudget::Refill(double ServerTimeSeconds)
+{
+	const int32 MaxBankedTicks = FMath::RoundToInt(MaxBankedSeconds * FCameraInputCommand::DeltaTimeScale);
+	
+	if(!bStarted)
+	{
+		bStarted = true;
+		LastRefillTime = ServerTimeSeconds;
+		RemainingTicks = MaxBankedTicks;
+		return;
+	}
+
+	// Whole ticks only, the remainder carries over to the next refill.
+	const int64 ElapsedTicks = FMath::FloorToInt64((ServerTimeSeconds - LastRefillTime) * FCameraInputCommand::DeltaTimeScale);
+	if(ElapsedTicks <= 0)
+	{
+		return;
+	}
+
+	LastRefillTime += static_cast<double>(ElapsedTicks) / FCameraInputCommand::DeltaTimeScale;
+	RemainingTicks = static_cast<int32>(FMath::Min<int64>(RemainingTicks + ElapsedTicks, MaxBankedTicks));
+}
+
+bool FCameraInputTimeBudget::Spend(FCameraInputCommand& Command)
+{
+	const int32 MaxCommandTicks = FMath::RoundToInt(MaxCommandSeconds * FCameraInputCommand::DeltaTimeScale);
+	const int32 AllowedTicks = FMath::Clamp(FMath::Min<int32>(Command.DeltaTime, MaxCommandTicks), 0, RemainingTicks);
+
+	const bool bCut = AllowedTicks != Command.DeltaTime;
+	Command.DeltaTime = static_cast<uint16>(AllowedTicks);
+	RemainingTicks -= AllowedTicks;
+	
+	return bCut;
+}
+
+int32 CameraNet::AcceptInputCommands(const FCameraInputCommandBatch& Batch, uint32& LastAppliedSequence, FCameraInputTimeBudget& Budget, TFunctionRef<void(const FCameraInputCommand&)> Apply)
+{
+	int32 NumCut = 0;
+	
+	for (const FCameraInputCommand& Command : Batch.Commands)
+	{
+		const uint32 Sequence = CameraNet::ResolveSequence(static_cast<uint16>(Command.Sequence), LastAppliedSequence);
+		
+		// Drop duplicated or out of order commands.
+		if(LastAppliedSequence != 0 && static_cast<int32>(Sequence - LastAppliedSequence) <= 0)
+		{
+			continue;
+		}
+
+		LastAppliedSequence = Sequence;
+
+		FCameraInputCommand AcceptedCommand = Command;
+		AcceptedCommand.Sequence = Sequence;
+		NumCut += Budget.Spend(AcceptedCommand) ? 1 : 0;
+		
+		Apply(AcceptedCommand);
+	}
+
+	return NumCut;
+}
@@ -0,0 +1,70 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraMoveHistory.h"
+
+void FCameraMoveHistory::Init(int32 InCapacity)
+{
+	const uint32 Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InCapacity, 2)));
+
+	Moves.SetNum(Capacity);
+	IndexMask = Capacity - 1;
+	OverflowCount = 0;
+	Reset();
+}
+
+void FCameraMoveHistory::Reset()
+{
+	OldestSequence = NextSequence;
+}
+
+FCameraMoveData& FCameraMoveHistory::Add()
+{
+	check(Moves.Num() > 0);
+
+	if(Num() == Moves.Num())
+	{
+		++OldestSequence;
+		++OverflowCount;
+	}
+
+	// Skip the reserved sequence on wrap around.
+	if(NextSequence == 0)
+	{
+		OldestSequence += (OldestSequence == 0) ? 1 : 0;
+		++NextSequence;
+	}
+
+	FCameraMoveData& Move = Moves[NextSequence & IndexMask];
+	Move = FCameraMoveData();
+	Move.Sequence = NextSequence++;
+
+	HighWaterMark = FMath::Max(HighWaterMark, Num());
+	return Move;
+}
+
+FCameraMoveData* FCameraMoveHistory::Find(uint32 Sequence)
+{
+	return Contains(Sequence) ? &Moves[Sequence & IndexMask] : nullptr;
+}
+
+FCameraMoveData* FCameraMoveHistory::GetNewest()
+{
+	return IsEmpty() ? nullptr : &Moves[(NextSequence - 1) & IndexMask];
+}
+
+void FCameraMoveHistory::Acknowledge(uint32 Sequence)
+{
+	if(Contains(Sequence))
+	{
+		OldestSequence = Sequence + 1;
+	}
+}
+
+bool FCameraMoveHistory::Contains(uint32 Sequence) const
+{
+	// Wrap-safe range check for OldestSequence <= Sequence < NextSequence.
+	return Sequence != 0
+		&& static_cast<int32>(Sequence - OldestSequence) >= 0
+		&& static_cast<int32>(NextSequence - Sequence) > 0;
+}
@@ -0,0 +1,155 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraNetState.h"
+
+namespace CameraNetState
+{
+	constexpr float LocationScale = 10.f;
+	constexpr double ServerTimeScale = 1000.0;
+
+	// Zig-zag encoding so small negative values stay small when packed.
+	uint32 ZigZag(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	int32 UnZigZag(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+}
+
+void FCameraNetState::SetLocation(const FVector& InLocation)
+{
+	Location.X = FMath::RoundToInt(InLocation.X * CameraNetState::LocationScale);
+	Location.Y = FMath::RoundToInt(InLocation.Y * CameraNetState::LocationScale);
+	Location.Z = FMath::RoundToInt(InLocation.Z * CameraNetState::LocationScale);
+	Flags |= LocationFlag;
+}
+
+void FCameraNetState::SetYaw(float InYaw)
+{
+	Yaw = FRotator::CompressAxisToShort(InYaw);
+	Flags |= YawFlag;
+}
+
+void FCameraNetState::SetZoomPercent(float InZoomPercent)
+{
+	ZoomPercent = static_cast<uint8>(FMath::RoundToInt(FMath::Clamp(InZoomPercent, 0.f, 1.f) * MAX_uint8));
+	Flags |= ZoomFlag;
+}
+
+void FCameraNetState::SetSequence(uint32 Sequence)
+{
+	SequenceBits = static_cast<uint16>(Sequence & MAX_uint16);
+	Flags |= SequenceFlag;
+}
+
+void FCameraNetState::SetServerTime(double ServerTimeSeconds)
+{
+	ServerTimeBits = static_cast<uint16>(FMath::FloorToInt64(ServerTimeSeconds * CameraNetState::ServerTimeScale) & MAX_uint16);
+	Flags |= ServerTimeFlag;
+}
+
+void FCameraNetState::SetTransform(const FTransform& Transform)
+{
+	SetLocation(Transform.GetLocation());
+	SetYaw(Transform.Rotator().Yaw);
+}
+
+FVector FCameraNetState::GetLocation() const
+{
+	return FVector(Location) / CameraNetState::LocationScale;
+}
+
+float FCameraNetState::GetYaw() const
+{
+	return FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(Yaw));
+}
+
+float FCameraNetState::GetZoomPercent() const
+{
+	return static_cast<float>(ZoomPercent) / MAX_uint8;
+}
+
+FTransform FCameraNetState::GetTransform() const
+{
+	return FTransform(FRotator(0.f, GetYaw(), 0.f), GetLocation());
+}
+
+uint32 FCameraNetState::ResolveSequence(uint32 Reference) const
+{
+	return HasSequence() ? CameraNet::ResolveSequence(SequenceBits, Reference) : 0;
+}
+
+double FCameraNetState::ResolveServerTime(double ReferenceSeconds) const
+{
+	if(!HasServerTime())
+	{
+		return ReferenceSeconds;
+	}
+
+	const int64 ReferenceMilliseconds = FMath::FloorToInt64(ReferenceSeconds * CameraNetState::ServerTimeScale);
+	const int16 Delta = static_cast<int16>(ServerTimeBits - static_cast<uint16>(ReferenceMilliseconds & MAX_uint16));
+	return (ReferenceMilliseconds + Delta) / CameraNetState::ServerTimeScale;
+}
+
+bool FCameraNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if(Ar.IsLoading())
+	{
+		*this = FCameraNetState();
+	}
+
+	Ar.SerializeBits(&Flags, NumFlagBits);
+
+	if(HasLocation())
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			uint32 Packed = CameraNetState::ZigZag(Location[Axis]);
+			Ar.SerializeIntPacked(Packed);
+			Location[Axis] = CameraNetState::UnZigZag(Packed);
+		}
+	}
+
+	if(HasYaw())
+	{
+		Ar << Yaw;
+	}
+
+	if(HasZoomPercent())
+	{
+		Ar << ZoomPercent;
+	}
+
+	if(HasSequence())
+	{
+		Ar << SequenceBits;
+	}
+
+	if(HasServerTime())
+	{
+		Ar << ServerTimeBits;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+bool FCameraNetState::operator==(const FCameraNetState& Other) const
+{
+	return Flags == Other.Flags
+		&& Location == Other.Location
+		&& Yaw == Other.Yaw
+		&& ZoomPercent == Other.ZoomPercent
+		&& SequenceBits == Other.SequenceBits
+		&& ServerTimeBits == Other.ServerTimeBits;
+}
+
+uint32 CameraNet::ResolveSequence(uint16 SequenceBits, uint32 Reference)
+{
+	const int16 Delta = static_cast<int16>(SequenceBits - static_cast<uint16>(Reference & MAX_uint16));
+	return Reference + Delta;
+}
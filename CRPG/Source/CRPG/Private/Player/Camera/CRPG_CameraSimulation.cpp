@@ -0,0 +1,70 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraSimulation.h"
+
+// CRPG
+#include "Player/Camera/CRPG_CameraEasing.h"
+#include "Player/Camera/CRPG_CameraInputCommand.h"
+
+FCameraSimulationState CameraSimulation::Step(const FCameraSimulationState& State, const FCameraInputCommand& Command, const FCameraSimulationSettings& Settings)
+{
+	FCameraSimulationState Result = State;
+	
+	const FVector2D Move = Command.GetMove();
+	const float YawInput = Command.GetYaw();
+	const float ZoomInput = Command.GetZoom();
+
+	// Step on the command's integer time base so no float error accumulates in the step count.
+	const int32 TicksPerSecond = FCameraInputCommand::DeltaTimeScale;
+	const int32 FixedStepTicks = FMath::Max(FMath::RoundToInt(Settings.FixedStep * TicksPerSecond), 1);
+	
+	for (int32 RemainingTicks = Command.DeltaTime; RemainingTicks > 0; RemainingTicks -= FixedStepTicks)
+	{
+		const float StepTime = static_cast<float>(FMath::Min(RemainingTicks, FixedStepTicks)) / TicksPerSecond;
+		const float EndYaw = Result.Yaw + YawInput * Settings.RotationSpeed * StepTime;
+
+		// The camera only moves in the plane, so its basis only depends on yaw. Moving along the basis averaged over
+		// the turn, rather than the one at the start of the step, integrates a turning move exactly, so the path
+		// doesn't depend on how the client's frame rate split the input into steps.
+		const double StartAngle = FMath::DegreesToRadians(static_cast<double>(Result.Yaw));
+		const double EndAngle = FMath::DegreesToRadians(static_cast<double>(EndYaw));
+		const double TurnAngle = EndAngle - StartAngle;
+		
+		double Sin;
+		double Cos;
+		if(FMath::Abs(TurnAngle) < UE_KINDA_SMALL_NUMBER)
+		{
+			FMath::SinCos(&Sin, &Cos, (StartAngle + EndAngle) * 0.5);
+		}
+		else
+		{
+			Cos = (FMath::Sin(EndAngle) - FMath::Sin(StartAngle)) / TurnAngle;
+			Sin = (FMath::Cos(StartAngle) - FMath::Cos(EndAngle)) / TurnAngle;
+		}
+		
+		const FVector Forward(Cos, Sin, 0.0);
+		const FVector Right(-Sin, Cos, 0.0);
+
+		Result.Location += (Forward * Move.Y + Right * Move.X) * Settings.MovementSpeed * StepTime;
+		Result.Yaw = FRotator::NormalizeAxis(EndYaw);
+		Result.ZoomPercent = FMath::Clamp(Result.ZoomPercent + ZoomInput * Settings.ZoomSpeed * StepTime, 0.f, 1.f);
+	}
+
+	return Result;
+}
+
+float CameraSimulation::EaseInOutCubic(float Alpha)
+{
+	return CameraEasing::Ease<ECameraEasing::CubicInOut>(Alpha);
+}
+
+float CameraSimulation::GetAngularDistance(const FRotator& A, const FRotator& B)
+{
+	const FRotator DeltaRotator = (A - B).GetNormalized();
+
+	return FMath::Sqrt(
+		FMath::Square(DeltaRotator.Pitch) +
+		FMath::Square(DeltaRotator.Yaw) +
+		FMath::Square(DeltaRotator.Roll));
+}
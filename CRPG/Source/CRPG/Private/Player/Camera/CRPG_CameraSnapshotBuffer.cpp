@@ -0,0 +1,89 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraSnapshotBuffer.h"
+
+void FCameraSnapshotBuffer::Init(int32 InCapacity)
+{
+	const uint32 Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InCapacity, 2)));
+
+	Snapshots.SetNum(Capacity);
+	IndexMask = Capacity - 1;
+	Reset();
+}
+
+void FCameraSnapshotBuffer::Reset()
+{
+	Oldest = 0;
+	Count = 0;
+}
+
+void FCameraSnapshotBuffer::Add(const FCameraSnapshot& Snapshot)
+{
+	check(Snapshots.Num() > 0);
+	
+	if(!IsEmpty() && Snapshot.Time <= GetNewest().Time)
+	{
+		return;
+	}
+
+	if(Num() == Snapshots.Num())
+	{
+		++Oldest;
+		--Count;
+	}
+
+	Snapshots[(Oldest + Count) & IndexMask] = Snapshot;
+	++Count;
+}
+
+bool FCameraSnapshotBuffer::Sample(double Time, double MaxExtrapolation, FCameraSnapshot& OutSnapshot) const
+{
+	if(IsEmpty())
+	{
+		return false;
+	}
+
+	if(Num() == 1 || Time <= Get(0).Time)
+	{
+		OutSnapshot = Get(0);
+		return true;
+	}
+
+	for (int32 Index = 1; Index < Num(); ++Index)
+	{
+		const FCameraSnapshot& To = Get(Index);
+		if(Time <= To.Time)
+		{
+			const FCameraSnapshot& From = Get(Index - 1);
+			OutSnapshot = Interpolate(From, To, (Time - From.Time) / (To.Time - From.Time));
+			return true;
+		}
+	}
+
+	// Underrun, keep going the way the camera was last moving for a moment.
+	const FCameraSnapshot& From = Get(Num() - 2);
+	const FCameraSnapshot& To = GetNewest();
+	const double ExtrapolationTime = FMath::Min(Time - To.Time, MaxExtrapolation);
+	OutSnapshot = Interpolate(From, To, 1.0 + ExtrapolationTime / (To.Time - From.Time));
+	return true;
+}
+
+void FCameraSnapshotBuffer::Trim(double Time)
+{
+	// Keep the snapshot at or before Time, it is the start of the segment being sampled.
+	while(Count > 2 && Get(1).Time <= Time)
+	{
+		++Oldest;
+		--Count;
+	}
+}
+
+FCameraSnapshot FCameraSnapshotBuffer::Interpolate(const FCameraSnapshot& From, const FCameraSnapshot& To, double Alpha)
+{
+	FCameraSnapshot Result;
+	Result.Time = FMath::Lerp(From.Time, To.Time, Alpha);
+	Result.Location = FMath::Lerp(From.Location, To.Location, Alpha);
+	Result.Yaw = FRotator::NormalizeAxis(From.Yaw + FRotator::NormalizeAxis(To.Yaw - From.Yaw) * static_cast<float>(Alpha));
+	return Result;
+}
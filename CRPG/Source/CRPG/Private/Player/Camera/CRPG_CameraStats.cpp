@@ -0,0 +1,8 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(CRPGCameraChannel);
+
+CSV_DEFINE_CATEGORY_MODULE(CRPG_API, CRPGCamera, true);
@@ -0,0 +1,69 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Camera/CRPG_CameraZoomTable.h"
+
+// UE
+#include "Algo/BinarySearch.h"
+#include "Components/SplineComponent.h"
+#include "Kismet/KismetMathLibrary.h"
+
+void FCameraZoomTable::Bake(const USplineComponent& Spline, const FTransform& SplineToTableSpace, const FVector& LookAtLocation, int32 NumSamples)
+{
+	Reset();
+
+	NumSamples = FMath::Max(NumSamples, 2);
+	Locations.Reserve(NumSamples);
+	Rotations.Reserve(NumSamples);
+	Distances.Reserve(NumSamples);
+
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		const float Time = static_cast<float>(Index) / (NumSamples - 1);
+		const FVector Location = SplineToTableSpace.TransformPosition(Spline.GetLocationAtTime(Time, ESplineCoordinateSpace::Local));
+
+		Locations.Add(Location);
+		Rotations.Add(UKismetMathLibrary::FindLookAtRotation(Location, LookAtLocation).Quaternion());
+		Distances.Add(FMath::Max(static_cast<float>(FVector::Dist(Location, LookAtLocation)), Index > 0 ? Distances.Last() : 0.f));
+	}
+}
+
+void FCameraZoomTable::Reset()
+{
+	Locations.Reset();
+	Rotations.Reset();
+	Distances.Reset();
+}
+
+FTransform FCameraZoomTable::Sample(float ZoomPercentage) const
+{
+	const int32 LastIndex = Locations.Num() - 1;
+	const float Position = FMath::Clamp(ZoomPercentage, 0.f, 1.f) * LastIndex;
+	const int32 Index = FMath::Min(FMath::FloorToInt32(Position), LastIndex - 1);
+	const float Alpha = Position - Index;
+
+	return FTransform(
+		FQuat::Slerp(Rotations[Index], Rotations[Index + 1], Alpha),
+		FMath::Lerp(Locations[Index], Locations[Index + 1], Alpha));
+}
+
+float FCameraZoomTable::FindZoomPercentForDistance(float Distance) const
+{
+	const int32 LastIndex = Distances.Num() - 1;
+	const int32 Index = Algo::LowerBound(Distances, Distance);
+	if(Index == 0)
+	{
+		return 0.f;
+	}
+	
+	if(Index > LastIndex)
+	{
+		return 1.f;
+	}
+
+	// Interpolate between the samples either side of Distance.
+	const float Span = Distances[Index] - Distances[Index - 1];
+	const float Alpha = Span > UE_KINDA_SMALL_NUMBER ? (Distance - Distances[Index - 1]) / Span : 1.f;
+	
+	return (Index - 1 + Alpha) / LastIndex;
+}
@@ -0,0 +1,84 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Selection/CRPG_CursorHitService.h"
+
+// CRPG
+#include "Game/CRPG_SelectableActorSubsystem.h"
+
+// UE
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cursor Hit Test"), STAT_CRPGCursorHitTest, STATGROUP_Game);
+
+UCRPG_CursorHitService::UCRPG_CursorHitService()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	PendingFrame = 0;
+	PendingRayStart = FVector::ZeroVector;
+	PendingRayEnd = FVector::ZeroVector;
+	bTraceInFlight = false;
+
+	TraceDelegate.BindUObject(this, &UCRPG_CursorHitService::OnTraceDone);
+}
+
+void UCRPG_CursorHitService::Update()
+{
+	// The previous trace lands next frame, never queue a second one behind it.
+	if(bTraceInFlight)
+	{
+		return;
+	}
+
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if(!IsValid(PlayerController) || !PlayerController->IsLocalController())
+	{
+		return;
+	}
+
+	FVector WorldLocation;
+	FVector WorldDirection;
+	if(!PlayerController->DeprojectMousePositionToWorld(WorldLocation, WorldDirection))
+	{
+		return;
+	}
+
+	PendingFrame = GFrameCounter;
+	PendingRayStart = WorldLocation;
+	PendingRayEnd = WorldLocation + WorldDirection * TraceDistance;
+	
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(CRPGCursorHitTest), false, PlayerController->GetViewTarget());
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, PendingRayStart, PendingRayEnd, TraceChannel, Params, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate);
+	bTraceInFlight = true;
+}
+
+void UCRPG_CursorHitService::OnTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CRPGCursorHitTest);
+	
+	bTraceInFlight = false;
+
+	CursorHit.Frame = PendingFrame;
+	CursorHit.RayStart = PendingRayStart;
+	CursorHit.RayEnd = PendingRayEnd;
+	CursorHit.bHit = !TraceDatum.OutHits.IsEmpty() && TraceDatum.OutHits[0].bBlockingHit;
+	CursorHit.Hit = CursorHit.bHit ? TraceDatum.OutHits[0] : FHitResult();
+
+	const UCRPG_SelectableActorSubsystem* SelectableActorSubsystem = GetWorld()->GetSubsystem<UCRPG_SelectableActorSubsystem>();
+	if(!IsValid(SelectableActorSubsystem))
+	{
+		CursorHit.Selectable = nullptr;
+	}
+	else if(CursorHit.bHit && SelectableActorSubsystem->Contains(CursorHit.Hit.GetActor()))
+	{
+		CursorHit.Selectable = CursorHit.Hit.GetActor();
+	}
+	else
+	{
+		// Only the part of the ray in front of the first hit can pass through a selectable.
+		CursorHit.Selectable = SelectableActorSubsystem->FindAlongRay(PendingRayStart, CursorHit.bHit ? CursorHit.Hit.ImpactPoint : PendingRayEnd);
+	}
+
+	OnCursorHitUpdated.Broadcast(CursorHit);
+}
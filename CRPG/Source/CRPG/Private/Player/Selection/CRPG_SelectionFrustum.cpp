@@ -0,0 +1,143 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+#include "Player/Selection/CRPG_SelectionFrustum.h"
+
+// UE
+#include "GameFramework/PlayerController.h"
+
+namespace SelectionFrustum
+{
+	// Smallest width and height, in pixels, of a rectangle turned into a frustum. A flat drag would otherwise deproject
+	// two corners onto the same ray and build a side plane with no normal.
+	constexpr double MinScreenRectExtent = 2.0;
+
+	// Signed distance of a sphere's surface past the plane, positive when any of it is on the inner side.
+	FORCEINLINE float GetSphereDistance(const FPlane4f& Plane, float X, float Y, float Z, float Radius)
+	{
+		return Plane.X * X + Plane.Y * Y + Plane.Z * Z - Plane.W + Radius;
+	}
+
+	bool IsSphereInside(const FSelectionFrustum& Frustum, const FSelectionBounds& Bounds, int32 Index)
+	{
+		for (const FPlane4f& Plane : Frustum.Planes)
+		{
+			if(GetSphereDistance(Plane, Bounds.X[Index], Bounds.Y[Index], Bounds.Z[Index], Bounds.Radius[Index]) < 0.f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+FSelectionFrustum FSelectionFrustum::FromCornerRays(const FVector (&Origins)[4], const FVector (&Directions)[4])
+{
+	// A point well inside the rectangle's view, used to face every plane inwards.
+	const FVector Center = (Origins[0] + Origins[1] + Origins[2] + Origins[3]) * 0.25
+		+ (Directions[0] + Directions[1] + Directions[2] + Directions[3]).GetSafeNormal() * 100.0;
+	
+	FSelectionFrustum Frustum;
+	for (int32 Edge = 0; Edge < 4; ++Edge)
+	{
+		const int32 Next = (Edge + 1) % 4;
+		
+		FPlane Plane(Origins[Edge], Origins[Edge] + Directions[Edge], Origins[Next] + Directions[Next]);
+		if(Plane.PlaneDot(Center) < 0.0)
+		{
+			Plane = Plane.Flip();
+		}
+		
+		Frustum.Planes[Edge] = FPlane4f(Plane);
+	}
+
+	return Frustum;
+}
+
+bool FSelectionFrustum::FromScreenRect(const APlayerController& PlayerController, const FVector2D& CornerA, const FVector2D& CornerB, FSelectionFrustum& OutFrustum)
+{
+	// Grow a thin rectangle around its center until both sides are at least the minimum extent.
+	const FVector2D Center = (CornerA + CornerB) * 0.5;
+	const FVector2D HalfExtent = FVector2D::Max((CornerA - CornerB).GetAbs(), FVector2D(SelectionFrustum::MinScreenRectExtent)) * 0.5;
+	const FVector2D Min = Center - HalfExtent;
+	const FVector2D Max = Center + HalfExtent;
+	const FVector2D Corners[4] = {Min, FVector2D(Max.X, Min.Y), Max, FVector2D(Min.X, Max.Y)};
+
+	FVector Origins[4];
+	FVector Directions[4];
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		if(!PlayerController.DeprojectScreenPositionToWorld(static_cast<float>(Corners[Index].X), static_cast<float>(Corners[Index].Y), Origins[Index], Directions[Index]))
+		{
+			return false;
+		}
+	}
+
+	OutFrustum = FromCornerRays(Origins, Directions);
+	return true;
+}
+
+void SelectionFrustum::CullSpheres(const FSelectionFrustum& Frustum, const FSelectionBounds& Bounds, TArray<int32>& OutIndices)
+{
+	VectorRegister4Float PlaneX[4];
+	VectorRegister4Float PlaneY[4];
+	VectorRegister4Float PlaneZ[4];
+	VectorRegister4Float PlaneW[4];
+	for (int32 PlaneIndex = 0; PlaneIndex < 4; ++PlaneIndex)
+	{
+		PlaneX[PlaneIndex] = VectorSetFloat1(Frustum.Planes[PlaneIndex].X);
+		PlaneY[PlaneIndex] = VectorSetFloat1(Frustum.Planes[PlaneIndex].Y);
+		PlaneZ[PlaneIndex] = VectorSetFloat1(Frustum.Planes[PlaneIndex].Z);
+		PlaneW[PlaneIndex] = VectorSetFloat1(Frustum.Planes[PlaneIndex].W);
+	}
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	
+	int32 Index = 0;
+	for (; Index + 4 <= Bounds.Num; Index += 4)
+	{
+		const VectorRegister4Float X = VectorLoad(Bounds.X + Index);
+		const VectorRegister4Float Y = VectorLoad(Bounds.Y + Index);
+		const VectorRegister4Float Z = VectorLoad(Bounds.Z + Index);
+		const VectorRegister4Float Radius = VectorLoad(Bounds.Radius + Index);
+
+		// Lane mask of the spheres on the inner side of a plane.
+		auto GetInside = [&](int32 PlaneIndex)
+		{
+			const VectorRegister4Float Distance = VectorMultiplyAdd(X, PlaneX[PlaneIndex],
+				VectorMultiplyAdd(Y, PlaneY[PlaneIndex],
+				VectorMultiplyAdd(Z, PlaneZ[PlaneIndex], VectorSubtract(Radius, PlaneW[PlaneIndex]))));
+			
+			return VectorCompareGE(Distance, Zero);
+		};
+
+		const VectorRegister4Float Inside = VectorBitwiseAnd(
+			VectorBitwiseAnd(GetInside(0), GetInside(1)),
+			VectorBitwiseAnd(GetInside(2), GetInside(3)));
+
+		for (uint32 Mask = static_cast<uint32>(VectorMaskBits(Inside)); Mask != 0; Mask &= Mask - 1)
+		{
+			OutIndices.Add(Index + FMath::CountTrailingZeros(Mask));
+		}
+	}
+
+	for (; Index < Bounds.Num; ++Index)
+	{
+		if(IsSphereInside(Frustum, Bounds, Index))
+		{
+			OutIndices.Add(Index);
+		}
+	}
+}
+
+void SelectionFrustum::CullSpheresScalar(const FSelectionFrustum& Frustum, const FSelectionBounds& Bounds, TArray<int32>& OutIndices)
+{
+	for (int32 Index = 0; Index < Bounds.Num; ++Index)
+	{
+		if(IsSphereInside(Frustum, Bounds, Index))
+		{
+			OutIndices.Add(Index);
+		}
+	}
+}
@@ -0,0 +1,241 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+// CRPG
+#include "Player/Camera/CRPG_CameraInputCommand.h"
+#include "Player/Camera/CRPG_CameraNetState.h"
+
+// UE
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CameraNetStateTests
+{
+	// Quantization steps of FCameraNetState. Rounding may be off by at most half a step, plus float slack.
+	constexpr double MaxLocationError = 0.05 + UE_KINDA_SMALL_NUMBER;
+	constexpr float MaxYawError = 360.f / 65536.f * 0.5f + 1e-4f;
+	constexpr float MaxZoomPercentError = 0.5f / MAX_uint8 + UE_KINDA_SMALL_NUMBER;
+
+	// The old WORLD_MAX, well beyond any map this game ships.
+	constexpr double WorldEdge = 2097152.0;
+
+	struct FZoomCase
+	{
+		float Sent;
+		float Expected;
+	};
+
+	struct FSequenceCase
+	{
+		uint32 Sequence;
+		uint32 Reference;
+	};
+
+	struct FServerTimeCase
+	{
+		double Time;
+		double Reference;
+	};
+
+	// Writes Value with NetSerialize and reads it back into a fresh struct, as the receiving end of an RPC would.
+	template<typename TStruct>
+	TStruct RoundTrip(const TStruct& Value, bool& bOutSuccess)
+	{
+		TStruct Sent = Value;
+		FNetBitWriter Writer(nullptr, 4096);
+		Sent.NetSerialize(Writer, nullptr, bOutSuccess);
+
+		TStruct Received;
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		bool bReadSuccess = false;
+		Received.NetSerialize(Reader, nullptr, bReadSuccess);
+
+		bOutSuccess &= bReadSuccess && !Reader.IsError() && Reader.AtEnd();
+		return Received;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraNetStateQuantizationTest, "CRPG.Camera.NetState.QuantizationBounds",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCameraNetStateQuantizationTest::RunTest(const FString& Parameters)
+{
+	using namespace CameraNetStateTests;
+
+	// Origin, sub-step offsets either side of zero, rounding midpoints, and the edges of the playable world.
+	const double LocationValues[] = {0.0, 0.04, -0.04, 0.05, -0.05, 0.149, 12345.678, -12345.678, WorldEdge, -WorldEdge};
+	for (const double X : LocationValues)
+	{
+		for (const double Z : {0.0, -X, 987.654})
+		{
+			const FVector Location(X, -X * 0.5, Z);
+
+			FCameraNetState State;
+			State.SetLocation(Location);
+
+			bool bSuccess = false;
+			const FCameraNetState Received = RoundTrip(State, bSuccess);
+			TestTrue(FString::Printf(TEXT("Location %s round trips"), *Location.ToString()), bSuccess && Received.HasLocation());
+			TestTrue(FString::Printf(TEXT("Received location matches the sent quantized location for %s"), *Location.ToString()), Received == State);
+
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const double Error = FMath::Abs(Received.GetLocation()[Axis] - Location[Axis]);
+				TestTrue(FString::Printf(TEXT("Location %s axis %d error %.4f is within %.4f"), *Location.ToString(), Axis, Error, MaxLocationError), Error <= MaxLocationError);
+			}
+		}
+	}
+
+	// Both ends of the normalized range, just inside them, and angles that need wrapping.
+	const float YawValues[] = {-180.f, -179.999f, -0.001f, 0.f, 0.001f, 90.f, 179.999f, 180.f, 359.99f, 720.5f, -540.25f};
+	for (const float Yaw : YawValues)
+	{
+		FCameraNetState State;
+		State.SetYaw(Yaw);
+
+		bool bSuccess = false;
+		const FCameraNetState Received = RoundTrip(State, bSuccess);
+		TestTrue(FString::Printf(TEXT("Yaw %.3f round trips"), Yaw), bSuccess && Received.HasYaw());
+
+		const float Error = FMath::Abs(FMath::FindDeltaAngleDegrees(Yaw, Received.GetYaw()));
+		TestTrue(FString::Printf(TEXT("Yaw %.3f error %.5f is within %.5f"), Yaw, Error, MaxYawError), Error <= MaxYawError);
+		TestTrue(FString::Printf(TEXT("Received yaw %.3f is normalized"), Received.GetYaw()), Received.GetYaw() >= -180.f && Received.GetYaw() <= 180.f);
+	}
+
+	// Out of range zoom clamps to the ends instead of wrapping.
+	const FZoomCase ZoomCases[] = {{0.f, 0.f}, {1.f, 1.f}, {0.5f, 0.5f}, {0.001f, 0.001f}, {-1.f, 0.f}, {2.f, 1.f}};
+	for (const FZoomCase& Zoom : ZoomCases)
+	{
+		FCameraNetState State;
+		State.SetZoomPercent(Zoom.Sent);
+
+		bool bSuccess = false;
+		const FCameraNetState Received = RoundTrip(State, bSuccess);
+		TestTrue(FString::Printf(TEXT("Zoom %.3f round trips"), Zoom.Sent), bSuccess && Received.HasZoomPercent());
+
+		const float Error = FMath::Abs(Received.GetZoomPercent() - Zoom.Expected);
+		TestTrue(FString::Printf(TEXT("Zoom %.3f error %.5f is within %.5f"), Zoom.Sent, Error, MaxZoomPercentError), Error <= MaxZoomPercentError);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraNetStateWrapTest, "CRPG.Camera.NetState.SequenceAndTimeWrap",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCameraNetStateWrapTest::RunTest(const FString& Parameters)
+{
+	using namespace CameraNetStateTests;
+
+	// Sequences that cross a 16 bit boundary resolve against a reference on either side of it.
+	const FSequenceCase SequenceCases[] = {{0, 0}, {1, 0}, {65535, 65534}, {65536, 65535}, {65539, 65535}, {65535, 65537}, {131072 + 5, 131072 - 5}, {70000, 70000 + 32767}};
+	for (const FSequenceCase& Sequence : SequenceCases)
+	{
+		FCameraNetState State;
+		State.SetSequence(Sequence.Sequence);
+
+		bool bSuccess = false;
+		const FCameraNetState Received = RoundTrip(State, bSuccess);
+		TestTrue(FString::Printf(TEXT("Sequence %u round trips"), Sequence.Sequence), bSuccess && Received.HasSequence());
+		TestEqual(FString::Printf(TEXT("Sequence %u resolved against %u"), Sequence.Sequence, Sequence.Reference), Received.ResolveSequence(Sequence.Reference), Sequence.Sequence);
+	}
+
+	// Server time wraps every 65.536 seconds and resolves to the millisecond.
+	const FServerTimeCase ServerTimeCases[] = {{0.0, 0.0}, {1000.1234, 1000.0}, {65.535, 65.537}, {65.537, 65.535}, {3600.25, 3600.25 - 30.0}, {3600.25, 3600.25 + 30.0}};
+	for (const FServerTimeCase& Time : ServerTimeCases)
+	{
+		FCameraNetState State;
+		State.SetServerTime(Time.Time);
+
+		bool bSuccess = false;
+		const FCameraNetState Received = RoundTrip(State, bSuccess);
+		TestTrue(FString::Printf(TEXT("Server time %.4f round trips"), Time.Time), bSuccess && Received.HasServerTime());
+
+		const double Error = FMath::Abs(Received.ResolveServerTime(Time.Reference) - Time.Time);
+		TestTrue(FString::Printf(TEXT("Server time %.4f resolved against %.4f is within a millisecond (%.5f)"), Time.Time, Time.Reference, Error), Error < 0.001 + UE_KINDA_SMALL_NUMBER);
+	}
+
+	// Nothing set writes nothing but the flags.
+	bool bSuccess = false;
+	const FCameraNetState Received = RoundTrip(FCameraNetState(), bSuccess);
+	TestTrue(TEXT("Empty state round trips"), bSuccess && Received == FCameraNetState());
+	TestEqual(TEXT("Empty state size in bits"), CameraNet::GetSerializedBits(FCameraNetState()), static_cast<int64>(5));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraInputCommandBatchTest, "CRPG.Camera.NetState.InputCommandBatch",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCameraInputCommandBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace CameraNetStateTests;
+
+	// Crosses the 16 bit boundary, then skips a few sequences as the client does when a frame had no input.
+	const uint32 Sequences[] = {65534, 65535, 65536, 65537, 65541, 65542};
+
+	FCameraInputCommandBatch Batch;
+	for (const uint32 Sequence : Sequences)
+	{
+		FCameraInputCommand& Command = Batch.Commands.AddDefaulted_GetRef();
+		Command.Sequence = Sequence;
+		Command.SetMove(FVector2D(1.5f, -1.f));
+		Command.SetYaw(Sequence % 2 ? 0.f : -0.3f);
+		Command.SetZoom(100.f);
+		Command.SetDeltaSeconds(1.f / 144.f);
+	}
+
+	bool bSuccess = false;
+	const FCameraInputCommandBatch Received = RoundTrip(Batch, bSuccess);
+	TestTrue(TEXT("Batch round trips"), bSuccess);
+
+	if(!TestEqual(TEXT("Received command count"), Received.Commands.Num(), Batch.Commands.Num()))
+	{
+		return false;
+	}
+
+	// The server resolves every command against the last sequence it applied before the batch.
+	const uint32 LastApplied = Sequences[0] - 1;
+	for (int32 Index = 0; Index < Batch.Commands.Num(); ++Index)
+	{
+		const FCameraInputCommand& Sent = Batch.Commands[Index];
+		const FCameraInputCommand& Command = Received.Commands[Index];
+
+		TestEqual(FString::Printf(TEXT("Command %d sequence"), Index), CameraNet::ResolveSequence(static_cast<uint16>(Command.Sequence), LastApplied), Sent.Sequence);
+		TestEqual(FString::Printf(TEXT("Command %d move X"), Index), Command.MoveX, Sent.MoveX);
+		TestEqual(FString::Printf(TEXT("Command %d move Y"), Index), Command.MoveY, Sent.MoveY);
+		TestEqual(FString::Printf(TEXT("Command %d yaw"), Index), Command.Yaw, Sent.Yaw);
+		TestEqual(FString::Printf(TEXT("Command %d zoom"), Index), Command.Zoom, Sent.Zoom);
+		TestEqual(FString::Printf(TEXT("Command %d delta time"), Index), Command.DeltaTime, Sent.DeltaTime);
+	}
+
+	// Quantization clamps out of range input and stays within half a step.
+	const FCameraInputCommand& First = Received.Commands[0];
+	TestNearlyEqual(TEXT("Move X clamps to 1"), First.GetMove().X, 1.0, 0.5 / 127.0);
+	TestNearlyEqual(TEXT("Move Y clamps to -1"), First.GetMove().Y, -1.0, 0.5 / 127.0);
+	TestEqual(TEXT("Zoom clamps to the int16 range"), First.Zoom, static_cast<int16>(MAX_int16));
+	TestNearlyEqual(TEXT("Yaw error"), First.GetYaw(), -0.3f, 0.5f / 1024.f);
+	TestNearlyEqual(TEXT("Delta time error"), First.GetDeltaSeconds(), 1.f / 144.f, 0.5f / FCameraInputCommand::DeltaTimeScale);
+
+	// Consecutive sequences cost one bit each instead of sixteen.
+	const int64 BatchBits = CameraNet::GetSerializedBits(Batch);
+	const int64 SeparateBits = CameraNet::GetSerializedBits(Batch.Commands);
+	TestTrue(FString::Printf(TEXT("Batch of %d commands takes %lld bits, fewer than %lld sent separately"), Batch.Commands.Num(), BatchBits, SeparateBits), BatchBits < SeparateBits);
+
+	// A count above the limit is rejected instead of allocating whatever the sender asked for.
+	FNetBitWriter Writer(nullptr, 64);
+	uint32 NumCommands = FCameraInputCommandBatch::MaxCommands + 1;
+	Writer.SerializeIntPacked(NumCommands);
+
+	FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+	FCameraInputCommandBatch Oversized;
+	bool bOversizedSuccess = true;
+	Oversized.NetSerialize(Reader, nullptr, bOversizedSuccess);
+	TestFalse(TEXT("Oversized batch is rejected"), bOversizedSuccess);
+	TestTrue(TEXT("Oversized batch reads no commands"), Oversized.Commands.IsEmpty());
+
+	return true;
+}
+
+#endif
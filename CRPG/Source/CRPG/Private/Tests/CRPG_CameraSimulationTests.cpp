@@ -0,0 +1,234 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+// CRPG
+#include "Player/Camera/CRPG_CameraInputCommand.h"
+#include "Player/Camera/CRPG_CameraNetState.h"
+#include "Player/Camera/CRPG_CameraSimulation.h"
+
+// UE
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CameraSimulationTests
+{
+	// Two seconds on the command time base.
+	constexpr int32 TotalTicks = 2 * FCameraInputCommand::DeltaTimeScale;
+
+	// ACRPG_PlayerCamera's default NetworkedMovementDifference. The server corrects the owner past this distance.
+	constexpr float NetworkedMovementDifference = 1.f;
+
+	FCameraSimulationSettings MakeSettings()
+	{
+		FCameraSimulationSettings Settings;
+		Settings.MovementSpeed = 1000.f;
+		Settings.RotationSpeed = 45.f;
+		Settings.ZoomSpeed = 0.1f;
+		Settings.FixedStep = 1.f / 60.f;
+		return Settings;
+	}
+
+	// TotalTicks of constant move, yaw and zoom input sent at FrameRate commands per second. Frame times carry their
+	// rounding into the next frame, as a client's would, so every frame rate covers the same total time.
+	TArray<FCameraInputCommand> MakeCommands(int32 FrameRate)
+	{
+		FCameraInputCommand Command;
+		Command.SetMove(FVector2D(0.5f, 1.f));
+		Command.SetYaw(1.f);
+		Command.SetZoom(0.5f);
+
+		TArray<FCameraInputCommand> Commands;
+		int32 SentTicks = 0;
+		for (int32 Frame = 1; SentTicks < TotalTicks; ++Frame)
+		{
+			const int32 FrameEndTicks = FMath::Min(FMath::RoundToInt(static_cast<double>(Frame) * FCameraInputCommand::DeltaTimeScale / FrameRate), TotalTicks);
+			
+			Command.Sequence = Frame;
+			Command.DeltaTime = static_cast<uint16>(FrameEndTicks - SentTicks);
+			SentTicks = FrameEndTicks;
+
+			Commands.Add(Command);
+		}
+
+		return Commands;
+	}
+
+	// The owning client's prediction.
+	FCameraSimulationState Simulate(TConstArrayView<FCameraInputCommand> Commands, const FCameraSimulationSettings& Settings)
+	{
+		FCameraSimulationState State;
+		for (const FCameraInputCommand& Command : Commands)
+		{
+			State = CameraSimulation::Step(State, Command, Settings);
+		}
+
+		return State;
+	}
+
+	FCameraSimulationState Simulate(int32 FrameRate, const FCameraSimulationSettings& Settings)
+	{
+		return Simulate(MakeCommands(FrameRate), Settings);
+	}
+
+	// What the server receives for Batch, through the same NetSerialize the RPC uses.
+	FCameraInputCommandBatch SendBatch(const FCameraInputCommandBatch& Batch, bool& bOutSuccess)
+	{
+		FCameraInputCommandBatch Sent = Batch;
+		FNetBitWriter Writer(nullptr, 4096);
+		Sent.NetSerialize(Writer, nullptr, bOutSuccess);
+
+		FCameraInputCommandBatch Received;
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		bool bReadSuccess = false;
+		Received.NetSerialize(Reader, nullptr, bReadSuccess);
+
+		bOutSuccess &= bReadSuccess && !Reader.IsError();
+		return Received;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraSimulationFrameRateTest, "CRPG.Camera.Simulation.FrameRateAgreement",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCameraSimulationFrameRateTest::RunTest(const FString& Parameters)
+{
+	using namespace CameraSimulationTests;
+
+	const FCameraSimulationSettings Settings = MakeSettings();
+	const FCameraSimulationState State30 = Simulate(30, Settings);
+	const FCameraSimulationState State144 = Simulate(144, Settings);
+
+	// Yaw and zoom change linearly with time, so only float error separates them.
+	TestNearlyEqual(TEXT("Yaw at 30 Hz and 144 Hz"), State30.Yaw, State144.Yaw, 0.01f);
+	TestNearlyEqual(TEXT("Zoom at 30 Hz and 144 Hz"), State30.ZoomPercent, State144.ZoomPercent, 1e-4f);
+
+	// Sub-steps split differently at different frame rates, but each one integrates the turn exactly, so the paths
+	// must agree closely enough that the server would never correct the owner.
+	const double LocationError = FVector::Dist(State30.Location, State144.Location);
+	TestTrue(FString::Printf(TEXT("Location error %.4f at 30 Hz and 144 Hz is within %.4f"), LocationError, NetworkedMovementDifference), LocationError <= NetworkedMovementDifference);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraSimulationReplayTest, "CRPG.Camera.Simulation.ClientServerReplay",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCameraSimulationReplayTest::RunTest(const FString& Parameters)
+{
+	using namespace CameraSimulationTests;
+
+	// The client predicts at 144 Hz, starting past the 16 bit sequence wrap, and bundles four frames per RPC.
+	constexpr int32 FrameRate = 144;
+	constexpr int32 FramesPerPacket = 4;
+	constexpr uint32 FirstSequence = 65530;
+	constexpr double Latency = 0.1;
+	
+	const FCameraSimulationSettings Settings = MakeSettings();
+	TArray<FCameraInputCommand> Commands = MakeCommands(FrameRate);
+	for (FCameraInputCommand& Command : Commands)
+	{
+		Command.Sequence += FirstSequence;
+	}
+	
+	const FCameraSimulationState Predicted = Simulate(Commands, Settings);
+
+	// The server has applied everything before this run.
+	FCameraSimulationState Server;
+	uint32 LastAppliedSequence = FirstSequence;
+	FCameraInputTimeBudget Budget;
+	int32 NumCut = 0;
+	int32 NumApplied = 0;
+	int32 SentTicks = 0;
+
+	for (int32 First = 0; First < Commands.Num(); First += FramesPerPacket)
+	{
+		FCameraInputCommandBatch Batch;
+		Batch.Commands.Append(Commands.GetData() + First, FMath::Min(FramesPerPacket, Commands.Num() - First));
+
+		bool bSuccess = false;
+		const FCameraInputCommandBatch Received = SendBatch(Batch, bSuccess);
+		TestTrue(FString::Printf(TEXT("Batch starting at command %d serializes"), First), bSuccess);
+
+		// Arrives a fixed latency after the client sent it.
+		for (const FCameraInputCommand& Command : Batch.Commands)
+		{
+			SentTicks += Command.DeltaTime;
+		}
+		
+		Budget.Refill(static_cast<double>(SentTicks) / FCameraInputCommand::DeltaTimeScale + Latency);
+		NumCut += CameraNet::AcceptInputCommands(Received, LastAppliedSequence, Budget, [&](const FCameraInputCommand& Command)
+		{
+			Server = CameraSimulation::Step(Server, Command, Settings);
+			++NumApplied;
+		});
+
+		// Unreliable RPCs can be duplicated, the copy must not be applied again.
+		if(First == 0)
+		{
+			CameraNet::AcceptInputCommands(Received, LastAppliedSequence, Budget, [&](const FCameraInputCommand&)
+			{
+				++NumApplied;
+			});
+		}
+	}
+
+	TestEqual(TEXT("Commands applied by the server"), NumApplied, Commands.Num());
+	TestEqual(TEXT("Commands cut to the time budget"), NumCut, 0);
+	TestEqual(TEXT("Last applied sequence"), LastAppliedSequence, Commands.Last().Sequence);
+
+	TestTrue(TEXT("Server location matches the prediction exactly"), Predicted.Location == Server.Location);
+	TestEqual(TEXT("Server yaw matches the prediction exactly"), Predicted.Yaw, Server.Yaw);
+	TestEqual(TEXT("Server zoom matches the prediction exactly"), Predicted.ZoomPercent, Server.ZoomPercent);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraSimulationTimeBudgetTest, "CRPG.Camera.Simulation.InputTimeBudget",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCameraSimulationTimeBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace CameraSimulationTests;
+
+	// A client claiming the longest frame time a command can carry, ten times per second of server time.
+	constexpr int32 NumCommands = 50;
+	constexpr double SendInterval = 0.1;
+
+	const FCameraSimulationSettings Settings = MakeSettings();
+	
+	FCameraInputCommand Command;
+	Command.SetMove(FVector2D(0.f, 1.f));
+	Command.DeltaTime = MAX_uint16;
+
+	FCameraSimulationState Server;
+	uint32 LastAppliedSequence = 0;
+	FCameraInputTimeBudget Budget;
+	int32 NumCut = 0;
+	
+	for (int32 Index = 0; Index < NumCommands; ++Index)
+	{
+		FCameraInputCommandBatch Batch;
+		Command.Sequence = Index + 1;
+		Batch.Commands.Add(Command);
+
+		Budget.Refill(Index * SendInterval);
+		NumCut += CameraNet::AcceptInputCommands(Batch, LastAppliedSequence, Budget, [&](const FCameraInputCommand& Accepted)
+		{
+			TestTrue(TEXT("Accepted frame time is within the per-command limit"), Accepted.GetDeltaSeconds() <= FCameraInputTimeBudget::MaxCommandSeconds + UE_KINDA_SMALL_NUMBER);
+			Server = CameraSimulation::Step(Server, Accepted, Settings);
+		});
+	}
+
+	TestEqual(TEXT("Every command was cut"), NumCut, NumCommands);
+
+	// The camera can't have covered more than the server time that passed plus the bank.
+	const double ElapsedSeconds = (NumCommands - 1) * SendInterval;
+	const double MaxDistance = Settings.MovementSpeed * (ElapsedSeconds + FCameraInputTimeBudget::MaxBankedSeconds);
+	const double Distance = Server.Location.Size();
+	TestTrue(FString::Printf(TEXT("Distance %.1f is within %.1f"), Distance, MaxDistance), Distance <= MaxDistance + NetworkedMovementDifference);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,147 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+
+// CRPG
+#include "Game/CRPG_ReplicationGraph.h"
+#include "Player/CRPG_PlayerCamera.h"
+#include "Player/CRPG_PlayerController.h"
+
+// UE
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationCommon.h"
+#include "Tests/AutomationEditorCommon.h"
+
+namespace ReplicationGraphTests
+{
+	const TCHAR* MapName = TEXT("/Game/Levels/StartupMap");
+	
+	constexpr int32 NumClients = 2;
+
+	// The budget CRPG_CameraNetBenchmark is run against.
+	constexpr int32 MaxActorsConsidered = 64;
+
+	// Time the clients get to join and spawn their cameras.
+	constexpr double JoinTimeout = 30.0;
+
+	UWorld* FindServerWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if(Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NM_DedicatedServer)
+			{
+				return World;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// Every client connected and its camera spawned.
+	bool HaveClientsJoined(const UNetDriver* NetDriver)
+	{
+		if(!NetDriver || NetDriver->ClientConnections.Num() < NumClients)
+		{
+			return false;
+		}
+
+		for (const UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			const ACRPG_PlayerController* PlayerController = Connection ? Cast<ACRPG_PlayerController>(Connection->PlayerController) : nullptr;
+			if(!PlayerController || !IsValid(PlayerController->GetPlayerCamera()))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+// Starts a PIE session with a dedicated server and NumClients clients in one process.
+DEFINE_LATENT_AUTOMATION_COMMAND(FStartNetworkedPIECommand);
+
+bool FStartNetworkedPIECommand::Update()
+{
+	ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+	PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_Client);
+	PlaySettings->SetPlayNumberOfClients(ReplicationGraphTests::NumClients);
+	PlaySettings->SetRunUnderOneProcess(true);
+
+	FRequestPlaySessionParams Params;
+	Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+	Params.EditorPlaySettings = PlaySettings;
+	GEditor->RequestPlaySession(Params);
+
+	return true;
+}
+
+// Gathers every connection's actor lists on the server once the clients have joined.
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FCheckActorsConsideredCommand, FAutomationTestBase*, Test);
+
+bool FCheckActorsConsideredCommand::Update()
+{
+	using namespace ReplicationGraphTests;
+
+	UWorld* ServerWorld = FindServerWorld();
+	UNetDriver* NetDriver = ServerWorld ? ServerWorld->GetNetDriver() : nullptr;
+	if(!HaveClientsJoined(NetDriver))
+	{
+		if(GetCurrentRunTime() < JoinTimeout)
+		{
+			return false;
+		}
+
+		Test->AddError(FString::Printf(TEXT("%d client(s) didn't join with a camera within %.0f seconds."), NumClients, JoinTimeout));
+		return true;
+	}
+
+	UCRPG_ReplicationGraph* ReplicationGraph = Cast<UCRPG_ReplicationGraph>(NetDriver->GetReplicationDriver());
+	if(!ReplicationGraph)
+	{
+		Test->AddError(TEXT("The server isn't using the CRPG replication graph."));
+		return true;
+	}
+
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		const FString ConnectionName = Connection->GetName();
+		
+		TArray<AActor*> Actors;
+		if(!Test->TestTrue(FString::Printf(TEXT("%s is known to the graph"), *ConnectionName), ReplicationGraph->GatherActorsConsideredForConnection(Connection, Actors)))
+		{
+			continue;
+		}
+
+		Test->TestTrue(FString::Printf(TEXT("%s considers %d actor(s), at least one"), *ConnectionName, Actors.Num()), Actors.Num() > 0);
+		Test->TestTrue(FString::Printf(TEXT("%s considers %d actor(s), at most %d"), *ConnectionName, Actors.Num(), MaxActorsConsidered), Actors.Num() <= MaxActorsConsidered);
+		Test->TestEqual(FString::Printf(TEXT("Actors gathered more than once for %s"), *ConnectionName), Actors.Num() - TSet<AActor*>(Actors).Num(), 0);
+
+		const ACRPG_PlayerController* PlayerController = CastChecked<ACRPG_PlayerController>(Connection->PlayerController);
+		Test->TestTrue(FString::Printf(TEXT("%s considers its own camera"), *ConnectionName), Actors.Contains(PlayerController->GetPlayerCamera()));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReplicationGraphActorsConsideredTest, "CRPG.Net.ReplicationGraph.ActorsConsidered",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FReplicationGraphActorsConsideredTest::RunTest(const FString& Parameters)
+{
+	ADD_LATENT_AUTOMATION_COMMAND(FEditorLoadMap(ReplicationGraphTests::MapName));
+	ADD_LATENT_AUTOMATION_COMMAND(FStartNetworkedPIECommand());
+	ADD_LATENT_AUTOMATION_COMMAND(FCheckActorsConsideredCommand(this));
+	ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+
+	return true;
+}
+
+#endif
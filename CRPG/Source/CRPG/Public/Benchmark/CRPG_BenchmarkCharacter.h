@@ -0,0 +1,31 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CRPG_BaseCharacter.h"
+#include "Characters/CRPG_CharacterTickState.h"
+#include "CRPG_BenchmarkCharacter.generated.h"
+
+/**
+ * A character that advances its gameplay state in its own actor tick, with the same kernel and commit the batched
+ * UCRPG_CharacterTickSubsystem update uses. Spawned by UCRPG_GameplayBenchmarkCommandlet to time real per-actor ticks
+ * against the batch. Not for gameplay.
+ */
+UCLASS(NotPlaceable, NotBlueprintable, Transient)
+class CRPG_API ACRPG_BenchmarkCharacter : public ACRPG_BaseCharacter
+{
+	GENERATED_BODY()
+
+public:
+	ACRPG_BenchmarkCharacter();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Replaces the state Tick advances. Only matters while the actor tick is enabled.
+	void SetGameplayState(float ActionCooldown, float StatusTime, float StatusDamageRate);
+
+private:
+	// A single character's worth of FCharacterTickState.
+	FCharacterTickState GameplayState;
+};
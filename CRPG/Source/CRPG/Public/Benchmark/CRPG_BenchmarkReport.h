@@ -0,0 +1,53 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Where a timing commandlet writes its results and which baseline it checks them against.
+struct FBenchmarkReportSettings
+{
+	FString OutputPath;
+	FString BaselinePath;
+
+	// Largest slowdown against the baseline, as a fraction, before a result counts as a regression.
+	double Threshold {0.15};
+
+	// Writes the results as the new baseline instead of checking them.
+	bool bUpdateBaseline {false};
+};
+
+/**
+ * Results handling shared by the timing commandlets: -Output, -Baseline, -Threshold and -UpdateBaseline.
+ * Results are nanoseconds per iteration by name. Baselines record the machine they were measured on, and runs on
+ * another machine or build configuration report their changes without failing.
+ */
+namespace BenchmarkReport
+{
+	// Reads the settings from a commandlet's parameters. Name picks the default paths, Saved/<Name>Benchmark.json and
+	// Benchmark/<Name>Baseline.json in the project directory.
+	CRPG_API FBenchmarkReportSettings ParseSettings(const TMap<FString, FString>& ParamValues, const TArray<FString>& Switches, const FString& Name);
+
+	// Logs and writes Results, then updates or checks the baseline. Returns the commandlet's exit code, 1 when a
+	// result regressed past the threshold or a file couldn't be read or written.
+	CRPG_API int32 Report(const FBenchmarkReportSettings& Settings, const TMap<FString, double>& Results, int64 Iterations);
+
+	// Runs Kernel Iterations times after a short warm up and returns nanoseconds per iteration.
+	// Every result is summed into Sink so the work can't be optimized away.
+	template<typename TKernel>
+	double Time(int64 Iterations, double& Sink, TKernel&& Kernel)
+	{
+		for (int64 Iteration = 0; Iteration < FMath::Min<int64>(Iterations / 10, 16384); ++Iteration)
+		{
+			Sink += Kernel(Iteration);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int64 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Sink += Kernel(Iteration);
+		}
+		
+		return (FPlatformTime::Seconds() - StartTime) * 1e9 / Iterations;
+	}
+}
@@ -0,0 +1,34 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CRPG_CameraKernelBenchmarkCommandlet.generated.h"
+
+/**
+ * Times each camera math kernel in isolation and compares the results against a baseline. Gameplay kernels that
+ * scale with unit counts are timed by UCRPG_GameplayBenchmarkCommandlet.
+ *
+ * UnrealEditor-Cmd CRPG.uproject -run=CRPG_CameraKernelBenchmark [-Iterations=5000000] [-Output=File.json]
+ *	[-Baseline=File.json] [-Threshold=0.15] [-UpdateBaseline]
+ *
+ * Returns 1 when a kernel is slower than its baseline by more than Threshold (a fraction). The baseline,
+ * Benchmark/CameraKernelBaseline.json by default, is a measured run recorded with -UpdateBaseline on the machine that
+ * checks it, in the build configuration it checks. It stores the CPU and build configuration it was recorded with;
+ * a run on anything else still reports the changes but doesn't fail, since the numbers aren't comparable.
+ */
+UCLASS()
+class CRPG_API UCRPG_CameraKernelBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCRPG_CameraKernelBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Nanoseconds per iteration of each kernel, by name.
+	TMap<FString, double> RunKernels(int64 Iterations) const;
+};
@@ -0,0 +1,49 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CRPG_CameraNetBenchmarkCommandlet.generated.h"
+
+class FJsonObject;
+
+/**
+ * Headless camera network benchmark. For each client count it starts a -nullrhi dedicated server and that many -nullrhi
+ * clients on this machine. Each process runs UCRPG_CameraNetBenchmarkSubsystem. The per-process results are merged into
+ * summary.json in the output directory.
+ *
+ * UnrealEditor-Cmd CRPG.uproject -run=CRPG_CameraNetBenchmark -Map=/Game/Maps/MyMap -Clients=1,4,8 -Duration=30
+ *	[-PktLag=100] [-PktLagVariance=20] [-PktLoss=2] [-Port=17777] [-Output=Dir] [-MaxActorsConsidered=64]
+ *
+ * With the CRPG replication graph the server also reports how many actors it considers per connection per frame.
+ * With -MaxActorsConsidered the run fails when any round goes over it.
+ *
+ * Packet emulation is applied to the outgoing packets of every process, so a round trip sees the lag twice.
+ * It requires a build with net test features, i.e. not Shipping.
+ */
+UCLASS()
+class CRPG_API UCRPG_CameraNetBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCRPG_CameraNetBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Runs one server and NumClients clients to completion and merges their results. Returns nullptr if any are missing.
+	TSharedPtr<FJsonObject> RunRound(int32 NumClients) const;
+
+	static TSharedPtr<FJsonObject> LoadResults(const FString& Path);
+
+	FString Map;
+	double Duration;
+	int32 Port;
+	FString NetworkEmulationArgs;
+	FString OutputDirectory;
+
+	// Fails the run when the server gathers more actors than this for any connection in a frame. 0 to only report.
+	int32 MaxActorsConsidered;
+};
@@ -0,0 +1,71 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CRPG_CameraNetBenchmarkSubsystem.generated.h"
+
+class FJsonObject;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCRPGCameraNetBenchmark, Log, All);
+
+/**
+ * Measures camera networking in one process of a UCRPG_CameraNetBenchmarkCommandlet run. Only created with -CameraNetBench.
+ * On a client it drives the local camera with scripted move, rotate, zoom and lock input.
+ * Every second it samples camera message counters, connection bytes and frame time.
+ * After -CameraNetBenchDuration seconds it writes the samples as JSON to -CameraNetBenchOutput and exits.
+ */
+UCLASS()
+class CRPG_API UCRPG_CameraNetBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	bool IsServer() const;
+
+	// Feeds the local camera input that exercises every camera message: moves, rotation, zoom and periodic locks.
+	void TickScriptedInput(float DeltaTime);
+
+	void TakeSample();
+	void WriteResults();
+
+	/* --- BEGIN: Settings --- */
+
+	double Duration;
+	FString OutputPath;
+
+	// Offsets the scripted input so clients don't move in lockstep.
+	int32 ClientIndex;
+
+	/* --- END: Settings --- */
+
+	/* --- BEGIN: Sampling --- */
+
+	double ElapsedTime;
+	double SampleElapsedTime;
+
+	int32 NumSampledFrames;
+	double SampledFrameTime;
+	double MaxSampledFrameTime;
+
+	// Camera counter totals at the previous sample, to turn them into rates.
+	uint32 LastInputRpcs;
+	uint32 LastAcks;
+	uint32 LastCorrections;
+	uint32 LastZoomSnapshots;
+
+	TArray<TSharedPtr<FJsonObject>> Samples;
+	bool bFinished;
+
+	/* --- END: Sampling --- */
+};
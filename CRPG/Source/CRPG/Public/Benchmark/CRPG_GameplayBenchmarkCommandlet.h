@@ -0,0 +1,45 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CRPG_GameplayBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the gameplay work that scales with unit counts and compares the results against a baseline.
+ *
+ * UnrealEditor-Cmd CRPG.uproject -run=CRPG_GameplayBenchmark [-Iterations=5000000] [-Frames=600] [-Output=File.json]
+ *	[-Baseline=File.json] [-Threshold=0.15] [-UpdateBaseline]
+ *
+ * Kernels, per iteration:
+ * - Group framing per group size (GroupBounds1 ... GroupBounds512), vectorized and scalar.
+ * - Marquee culling per unit count (MarqueeCull100 ... MarqueeCull10000), vectorized and scalar.
+ * - The batched character update on the game thread (CharacterTickSerial500, CharacterTickSerial20000) and in
+ *   UCRPG_CharacterTickSubsystem's ParallelFor chunks (CharacterTickParallel500, CharacterTickParallel20000).
+ *
+ * World ticks, per frame, for a game world with 500 ACRPG_BenchmarkCharacter actors:
+ * - CharacterWorldTickIdle500: no gameplay state is ticked.
+ * - CharacterWorldTickPerActor500: every character advances its state in its own actor tick.
+ * - CharacterWorldTickBatched500: UCRPG_CharacterTickSubsystem advances every character's state.
+ * The difference to Idle is what each way of ticking gameplay state costs with the engine's tick scheduling included.
+ *
+ * Baselines work as for UCRPG_CameraKernelBenchmarkCommandlet, the default is Benchmark/GameplayBaseline.json.
+ */
+UCLASS()
+class CRPG_API UCRPG_GameplayBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCRPG_GameplayBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Nanoseconds per iteration of each kernel, by name.
+	TMap<FString, double> RunKernels(int64 Iterations) const;
+
+	// Nanoseconds per frame of each world tick, by name.
+	TMap<FString, double> RunWorldTicks(int32 Frames) const;
+};
@@ -0,0 +1,58 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// What a character's update produced that needs the game thread.
+enum class ECharacterTickEvents : uint8
+{
+	None			= 0,
+	ActionReady		= 1 << 0,
+	StatusExpired	= 1 << 1,
+	Damaged			= 1 << 2
+};
+ENUM_CLASS_FLAGS(ECharacterTickEvents);
+
+/**
+ * Hot per-character gameplay state, one array per field so an update streams through only what it reads.
+ * Entries are swap-removed, so an index is only stable until the next removal.
+ */
+struct CRPG_API FCharacterTickState
+{
+	// Seconds until the character can act again.
+	TArray<float> ActionCooldowns;
+
+	// Seconds left on the character's status effect, and the damage per second it deals.
+	TArray<float> StatusTimes;
+	TArray<float> StatusDamageRates;
+
+	// Status damage dealt but not yet applied to the character.
+	TArray<float> PendingDamage;
+
+	// ECharacterTickEvents raised by the last update.
+	TArray<ECharacterTickEvents> Events;
+
+	int32 Num() const { return ActionCooldowns.Num(); }
+
+	// Adds an idle character and returns its index.
+	int32 Add();
+	void RemoveAtSwap(int32 Index);
+	void Reset();
+};
+
+/**
+ * Per-frame character update kernels. They only read and write the state of the indices they are given, so
+ * disjoint ranges can run on different threads. Anything touching actors belongs in the caller's commit phase.
+ */
+namespace CharacterTick
+{
+	// Advances characters Begin to End - 1 by DeltaTime and records their events.
+	CRPG_API void Update(FCharacterTickState& State, float DeltaTime, int32 Begin, int32 End);
+
+	// Update over every character, ChunkSize characters per ParallelFor task.
+	CRPG_API void UpdateParallel(FCharacterTickState& State, float DeltaTime, int32 ChunkSize);
+
+	// Whole points of pending damage, taken out of the pending amount.
+	CRPG_API float ConsumeDamage(FCharacterTickState& State, int32 Index);
+}
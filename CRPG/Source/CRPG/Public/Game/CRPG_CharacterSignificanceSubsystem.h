@@ -0,0 +1,98 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CRPG_CharacterSignificanceSubsystem.generated.h"
+
+class ACRPG_BaseCharacter;
+class ACRPG_PlayerCamera;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCRPGSignificance, Log, All);
+
+// How much detail a character is updated with, from most to least.
+UENUM()
+enum class ECharacterSignificanceTier : uint8
+{
+	Full,
+	Reduced,
+	Low,
+	Offscreen,
+	Num UMETA(Hidden)
+};
+
+/**
+ * Scores characters by how much of them the local player can see: their distance to the player camera's focus,
+ * relative to how much of the map the current zoom shows, scaled down as the camera zooms out, and zero off screen.
+ * The most significant characters are given the highest tier that still fits a fixed per-frame budget, and each tier
+ * sets animation update rate optimization, skeletal mesh tick interval and, for characters this machine doesn't have
+ * authority over, movement component tick interval. Authoritative movement always ticks at full rate, since gameplay
+ * and replication depend on it.
+ * Not created on dedicated servers, which have no local player to score for. Without rendering, such as a headless
+ * client, every character counts as on screen.
+ */
+UCLASS()
+class CRPG_API UCRPG_CharacterSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register(ACRPG_BaseCharacter* Character);
+	void Unregister(ACRPG_BaseCharacter* Character);
+
+	int32 Num() const { return Characters.Num(); }
+
+	// Characters in Tier as of the last Tick.
+	int32 GetTierCount(ECharacterSignificanceTier Tier) const { return TierCounts[static_cast<int32>(Tier)]; }
+
+	// Logs the characters per tier of every game world. Run with CRPG.Significance.LogTiers.
+	static void LogTiers(UWorld* World);
+
+	// Full rate characters a frame can afford. Lower tiers cost a fraction of one, off screen ones nothing.
+	static constexpr float CharacterBudget = 24.f;
+
+	// Distance from the focus at which a character stops being significant, fully zoomed in and fully zoomed out.
+	static constexpr float NearViewRadius = 2500.f;
+	static constexpr float FarViewRadius = 8000.f;
+
+	// Scale on every score when fully zoomed out, where characters are small on screen.
+	static constexpr float ZoomedOutDetail = 0.5f;
+
+private:
+	// What a character's components were set up with, restored in the full tier.
+	struct FCharacterDefaults
+	{
+		float MeshTickInterval {0.f};
+		float MovementTickInterval {0.f};
+		EVisibilityBasedAnimTickOption VisibilityBasedAnimTickOption {EVisibilityBasedAnimTickOption::AlwaysTickPose};
+		bool bEnableUpdateRateOptimizations {false};
+	};
+
+	// The camera of the first local player controller. Remote players' controllers on a listen server are skipped.
+	const ACRPG_PlayerCamera* FindLocalCamera() const;
+
+	void RemoveAt(int32 Index);
+
+	void ApplyTier(int32 Index, ECharacterSignificanceTier Tier);
+
+	// Characters, swap-removed on unregister.
+	TArray<TWeakObjectPtr<ACRPG_BaseCharacter>> Characters;
+	TArray<float> Scores;
+	TArray<ECharacterSignificanceTier> Tiers;
+	TArray<FCharacterDefaults> Defaults;
+
+	// Keys stay usable after their character is destroyed.
+	TArray<TObjectKey<ACRPG_BaseCharacter>> CharacterKeys;
+	TMap<TObjectKey<ACRPG_BaseCharacter>, int32> IndicesByCharacter;
+
+	// Character indices from most to least significant, rebuilt every Tick.
+	TArray<int32> SortedIndices;
+
+	int32 TierCounts[static_cast<int32>(ECharacterSignificanceTier::Num)] {};
+};
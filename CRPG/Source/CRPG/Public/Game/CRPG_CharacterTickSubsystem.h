@@ -0,0 +1,74 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CRPG_CharacterTickState.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CRPG_CharacterTickSubsystem.generated.h"
+
+class ACRPG_BaseCharacter;
+
+/**
+ * Ticks the gameplay state of every character in one pass instead of one actor tick each.
+ * The state lives in FCharacterTickState's contiguous arrays. Large casts are updated in chunks on worker threads,
+ * smaller ones on the game thread, then a short commit phase on the game thread hands the events they raised to the
+ * characters. Gameplay state is the server's,
+ * so characters only register with authority.
+ */
+UCLASS()
+class CRPG_API UCRPG_CharacterTickSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register(ACRPG_BaseCharacter* Character);
+	void Unregister(ACRPG_BaseCharacter* Character);
+
+	bool Contains(const ACRPG_BaseCharacter* Character) const { return IndicesByCharacter.Contains(Character); }
+
+	int32 Num() const { return Characters.Num(); }
+
+	// Blocks Character's next action for Seconds. OnActionReady is called when they have passed.
+	void StartActionCooldown(const ACRPG_BaseCharacter* Character, float Seconds);
+
+	// Seconds until Character can act again, 0 when it can act now.
+	float GetActionCooldown(const ACRPG_BaseCharacter* Character) const;
+
+	// Replaces Character's status effect with one dealing DamagePerSecond for Duration seconds.
+	void ApplyStatusEffect(const ACRPG_BaseCharacter* Character, float Duration, float DamagePerSecond);
+
+	// Characters per ParallelFor task. The update costs about 3.5 ns per character, so a chunk is roughly 15 us of work,
+	// enough to outweigh waking a worker and scheduling its task.
+	static constexpr int32 ChunkSize = 4096;
+
+	// Fewer characters than this are updated on the game thread. Below two full chunks the serial update finishes
+	// sooner than the parallel one could be dispatched and joined.
+	static constexpr int32 MinParallelCharacters = 2 * ChunkSize;
+
+private:
+	// Events gathered from the update, so a character unregistering while handling one can't reorder the state.
+	struct FCommit
+	{
+		TWeakObjectPtr<ACRPG_BaseCharacter> Character;
+		ECharacterTickEvents Events {ECharacterTickEvents::None};
+		float Damage {0.f};
+	};
+
+	void RemoveAt(int32 Index);
+
+	void Commit();
+
+	// Characters, indexed alongside State and swap-removed on unregister.
+	TArray<TWeakObjectPtr<ACRPG_BaseCharacter>> Characters;
+	FCharacterTickState State;
+
+	// Keys stay usable after their character is destroyed.
+	TArray<TObjectKey<ACRPG_BaseCharacter>> CharacterKeys;
+	TMap<TObjectKey<ACRPG_BaseCharacter>, int32> IndicesByCharacter;
+
+	TArray<FCommit> Commits;
+};
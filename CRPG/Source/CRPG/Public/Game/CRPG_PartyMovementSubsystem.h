@@ -0,0 +1,125 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavigationSystemTypes.h"
+#include "Game/CRPG_PartyPathCache.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CRPG_PartyMovementSubsystem.generated.h"
+
+class ANavigationData;
+
+// One party member's path to its goal.
+struct FPartyPathRequest
+{
+	TWeakObjectPtr<APawn> Member;
+	FVector Goal {FVector::ZeroVector};
+};
+
+struct FPartyPathResult
+{
+	TWeakObjectPtr<APawn> Member;
+	FVector Start {FVector::ZeroVector};
+	FVector Goal {FVector::ZeroVector};
+	
+	// Path points from the member's location to Goal. Empty when no path was found.
+	TArray<FVector> Points;
+	bool bFromCache {false};
+};
+
+DECLARE_DELEGATE_OneParam(FOnPartyPathsFound, const TArray<FPartyPathResult>&);
+
+/**
+ * Finds paths for a whole party order at once. Every member's query of an order is issued to the navigation system's
+ * async path finding in the same frame and the order completes when the last one is back. Found paths are kept in a
+ * small LRU cache keyed by snapped start and goal cells, so repeated orders near the same spot skip the navmesh.
+ * Only created on the server, where characters are moved.
+ */
+UCLASS()
+class CRPG_API UCRPG_PartyMovementSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCRPG_PartyMovementSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// Finds a path for every request. OnFound runs once with all results, straight away when all of them were cached.
+	// Returns the batch id, or 0 when there is no navigation system.
+	uint32 RequestPaths(TConstArrayView<FPartyPathRequest> Requests, FOnPartyPathsFound OnFound);
+
+	// Spreads Members over formation slots around Destination, facing away from the party, and moves each of them
+	// along its path with its AI controller, or a local player controller's path following. A newer order for a member
+	// supersedes this one, and the batch is cancelled once every one of its members was given a newer order.
+	uint32 MoveParty(TConstArrayView<APawn*> Members, const FVector& Destination);
+
+	// Drops a batch still in flight. Its callback never runs.
+	void CancelBatch(uint32 BatchId);
+
+	// Seconds from issuing the last completed batch to its last path arriving.
+	double GetLastBatchLatency() const { return LastBatchLatency; }
+
+	float GetCacheHitRate() const { return PathCache.GetHitRate(); }
+
+	// Members per formation row.
+	static constexpr int32 FormationColumns = 3;
+
+	// Distance between neighbouring formation slots.
+	static constexpr float FormationSpacing = 150.f;
+
+private:
+	struct FPathBatch
+	{
+		double StartTime {0.0};
+		int32 NumPending {0};
+		TArray<FPartyPathResult> Results;
+		FOnPartyPathsFound OnFound;
+	};
+
+	// A query in flight, shared by every result of its batch that snapped to the same cells.
+	struct FPendingQuery
+	{
+		uint32 BatchId {0};
+		FPartyPathCacheKey Key;
+		TArray<int32, TInlineAllocator<1>> ResultIndices;
+	};
+
+	// The latest order each member was given and the batch finding its path.
+	struct FMemberOrder
+	{
+		uint32 OrderId {0};
+		uint32 BatchId {0};
+	};
+
+	// Paths kept, and the cell their ends are snapped to.
+	static constexpr int32 PathCacheCapacity = 64;
+	static constexpr float PathCacheCellSize = 50.f;
+
+	FPartyPathCache PathCache;
+
+	TMap<uint32, FPathBatch> Batches;
+	TMap<uint32, FPendingQuery> PendingQueries;
+	TMap<TObjectKey<APawn>, FMemberOrder> OrdersByMember;
+
+	uint32 NextBatchId;
+	uint32 NextOrderId;
+	double LastBatchLatency;
+
+	FNavPathQueryDelegate PathQueryDelegate;
+
+	void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+	void CompleteBatch(uint32 BatchId);
+
+	// Moves Member along a found path with whatever controls it.
+	static void FollowPath(APawn& Member, const FPartyPathResult& Result);
+
+	// Cached paths may cross what the navmesh just changed.
+	UFUNCTION()
+	void OnNavigationGenerationFinished(ANavigationData* NavData);
+};
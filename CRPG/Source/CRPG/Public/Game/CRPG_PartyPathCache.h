@@ -0,0 +1,62 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+
+class ANavigationData;
+
+// A path query with its start and goal snapped to cells, so nearby repeats of an order share one entry.
+struct FPartyPathCacheKey
+{
+	TObjectKey<ANavigationData> NavData;
+	FIntVector StartCell {FIntVector::ZeroValue};
+	FIntVector GoalCell {FIntVector::ZeroValue};
+
+	bool operator==(const FPartyPathCacheKey& Other) const
+	{
+		return NavData == Other.NavData && StartCell == Other.StartCell && GoalCell == Other.GoalCell;
+	}
+
+	friend uint32 GetTypeHash(const FPartyPathCacheKey& Key)
+	{
+		return HashCombineFast(GetTypeHash(Key.NavData), HashCombineFast(GetTypeHash(Key.StartCell), GetTypeHash(Key.GoalCell)));
+	}
+};
+
+/**
+ * Least recently used cache of found paths. A cached path is returned with its end points moved onto the exact start
+ * and goal asked for, which are at most a cell away from the ones it was found for.
+ */
+struct CRPG_API FPartyPathCache
+{
+public:
+	FPartyPathCache();
+
+	void Init(int32 InCapacity, float InCellSize);
+
+	// Forgets every path, for when the navmesh they were found on changed.
+	void Reset();
+
+	FPartyPathCacheKey MakeKey(const ANavigationData* NavData, const FVector& Start, const FVector& Goal) const;
+
+	// Copies the path cached for Key into OutPoints and marks it most recently used. Counts towards the hit rate.
+	bool Find(const FPartyPathCacheKey& Key, const FVector& Start, const FVector& Goal, TArray<FVector>& OutPoints);
+
+	// Caches Points for Key, evicting the least recently used path when full.
+	void Store(const FPartyPathCacheKey& Key, const TArray<FVector>& Points);
+
+	// Fraction of Find calls served from the cache since the last Reset.
+	float GetHitRate() const;
+
+	int32 Num() const { return Paths.Num(); }
+
+private:
+	TLruCache<FPartyPathCacheKey, TArray<FVector>> Paths;
+
+	float CellSize;
+
+	int32 Hits;
+	int32 Misses;
+};
@@ -0,0 +1,43 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BasicReplicationGraph.h"
+#include "CRPG_ReplicationGraph.generated.h"
+
+/**
+ * The replication graph for the CRPG.
+ * Player cameras and characters are spatialized around each connection's viewer. The viewer is the focus of the
+ * connection's own camera, so that camera is always in range of its owner. Cameras replicate at the rate they set
+ * through SetActorNetUpdateFrequency.
+ */
+UCLASS(Transient, Config=Engine)
+class CRPG_API UCRPG_ReplicationGraph : public UBasicReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	// Sets Actor's replication period from Frequency. The graph takes an actor's period from its class, so actors that
+	// scale their NetUpdateFrequency at runtime must pass it on here.
+	void SetActorNetUpdateFrequency(AActor* Actor, float Frequency);
+
+	// Gathers Connection's actor lists from every node as a replication frame would and appends every actor in them to
+	// OutActors. For measuring, it does the gather work a second time. Returns false for an unknown connection.
+	bool GatherActorsConsideredForConnection(UNetConnection* Connection, TArray<AActor*>& OutActors);
+	
+	// Number of actors GatherActorsConsideredForConnection finds, or INDEX_NONE for an unknown connection.
+	int32 CountActorsConsideredForConnection(UNetConnection* Connection);
+
+protected:
+	// Distance from the viewer other players' cameras stay relevant within.
+	UPROPERTY(Config)
+	float OtherPlayerCameraCullDistance {20000.f};
+
+private:
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* FindAlwaysRelevantNodeForConnection(const UNetConnection* Connection) const;
+};
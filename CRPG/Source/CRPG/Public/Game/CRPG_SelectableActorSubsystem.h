@@ -0,0 +1,87 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CRPG_SelectableActorSubsystem.generated.h"
+
+struct FSelectionFrustum;
+
+/**
+ * Actors the player can select, with their locations sampled once per frame into contiguous arrays and hashed into
+ * a 2D grid. Cursor picking walks only the cells under the cursor ray instead of tracing against every actor.
+ * Selectables are approximated by upright capsules. Selection is local to each player, so dedicated servers don't
+ * create the subsystem and registering has to handle its absence.
+ */
+UCLASS()
+class CRPG_API UCRPG_SelectableActorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register(AActor* Actor, float Radius, float HalfHeight);
+	void Unregister(AActor* Actor);
+
+	// Closest selectable whose capsule the segment from RayStart to RayEnd passes through, or nullptr.
+	AActor* FindAlongRay(const FVector& RayStart, const FVector& RayEnd) const;
+
+	// Appends every selectable whose bounds are inside or touch Frustum, as of the last Tick.
+	void FindInFrustum(const FSelectionFrustum& Frustum, TArray<TWeakObjectPtr<AActor>>& OutActors) const;
+
+	bool Contains(const AActor* Actor) const { return IndicesByActor.Contains(Actor); }
+	
+	int32 Num() const { return Actors.Num(); }
+
+	// Locations as of the last Tick, indexed alongside GetActor.
+	TConstArrayView<FVector> GetLocations() const { return Locations; }
+	AActor* GetActor(int32 Index) const { return Actors[Index].Get(); }
+
+private:
+	// Size of a hash cell. Larger than any selectable so a capsule only spills into neighbouring cells.
+	static constexpr float CellSize = 400.f;
+
+	struct FShape
+	{
+		float Radius {0.f};
+		float HalfHeight {0.f};
+	};
+
+	struct FCellRange
+	{
+		int32 Start {0};
+		int32 Num {0};
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	void RemoveAt(int32 Index);
+
+	// Rebuilds the hash from the current locations.
+	void BuildHash();
+
+	// Selectables, swap-removed on unregister.
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TArray<FVector> Locations;
+	TArray<FShape> Shapes;
+
+	// Bounding spheres of the capsules as structure of arrays, for CullSpheres.
+	TArray<float> BoundsX;
+	TArray<float> BoundsY;
+	TArray<float> BoundsZ;
+	TArray<float> BoundsRadius;
+
+	// Keys stay usable after their actor is destroyed.
+	TArray<TObjectKey<AActor>> ActorKeys;
+	TMap<TObjectKey<AActor>, int32> IndicesByActor;
+
+	// Selectable indices sorted by cell, and the range each occupied cell covers in it. Rebuilt every Tick, so it
+	// can briefly miss actors registered or swapped since.
+	TArray<int32> SortedIndices;
+	TArray<FIntPoint> IndexCells;
+	TMap<FIntPoint, FCellRange> Cells;
+};
@@ -0,0 +1,79 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CRPG_TrackedActorSubsystem.generated.h"
+
+class UCRPG_TrackedActorSubsystem;
+
+// Samples the tracked actors in TG_PostPhysics, once characters have moved and physics has settled for the frame.
+struct FTrackedActorSampleTickFunction : public FTickFunction
+{
+	UCRPG_TrackedActorSubsystem* Subsystem {nullptr};
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+/**
+ * Samples the transform and velocity of actors that something follows once per frame into contiguous arrays.
+ * Followers register an actor, keep the returned handle and read the cached values, so an actor followed by
+ * several cameras is only resolved and read once. Registrations are reference counted.
+ * Sampling runs after the actors have moved. Followers that read in the same frame add the sample tick function as a
+ * prerequisite of their own tick with AddSamplePrerequisite, otherwise they see the previous frame's transforms.
+ */
+UCLASS()
+class CRPG_API UCRPG_TrackedActorSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// Makes TickFunction, which must tick in TG_PostPhysics or later, run after this frame's sample.
+	void AddSamplePrerequisite(FTickFunction& TickFunction);
+
+	// Samples every tracked actor. Run by the sample tick function.
+	void Sample(float DeltaTime);
+
+	// Starts tracking Actor, or adds a reference if it already is. Returns the handle, or INDEX_NONE for an invalid actor.
+	int32 Register(AActor* Actor);
+
+	// Releases a reference taken by Register.
+	void Unregister(int32 Handle);
+
+	// Whether Handle refers to an actor that was still valid at the last sample.
+	bool IsTracked(int32 Handle) const { return Entries.IsValidIndex(Handle) && Entries[Handle].RefCount > 0 && Entries[Handle].bValid; }
+
+	// Requires IsTracked(Handle).
+	const FTransform& GetTransform(int32 Handle) const { return Transforms[Handle]; }
+	const FVector& GetVelocity(int32 Handle) const { return Velocities[Handle]; }
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+
+		// Stays usable as the map key after the actor is destroyed.
+		TObjectKey<AActor> ActorKey;
+		
+		int32 RefCount {0};
+		bool bValid {false};
+	};
+
+	void SampleActor(int32 Handle, float DeltaTime);
+
+	FTrackedActorSampleTickFunction SampleTickFunction;
+
+	// Indexed by handle. Transforms and velocities are kept apart so readers touch only the data they use.
+	TArray<FEntry> Entries;
+	TArray<FTransform> Transforms;
+	TArray<FVector> Velocities;
+
+	TArray<int32> FreeHandles;
+	TMap<TObjectKey<AActor>, int32> HandlesByActor;
+};
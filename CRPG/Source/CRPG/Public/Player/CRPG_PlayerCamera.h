@@ -4,23 +4,80 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "WorldCollision.h"
+#include "Player/Camera/CRPG_CameraCommand.h"
+#include "Player/Camera/CRPG_CameraHeightField.h"
+#include "Player/Camera/CRPG_CameraInputCommand.h"
+#include "Player/Camera/CRPG_CameraMoveHistory.h"
+#include "Player/Camera/CRPG_CameraNetState.h"
+#include "Player/Camera/CRPG_CameraSimulation.h"
+#include "Player/Camera/CRPG_CameraSnapshotBuffer.h"
+#include "Player/Camera/CRPG_CameraZoomTable.h"
 #include "CRPG_PlayerCamera.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCRPGPlayerCamera, Log, All);
 
 class UCameraComponent;
+class UCRPG_CameraBoundsAsset;
 class USplineComponent;
 class USpringArmComponent;
 
+// How this machine relates to a camera, classified once instead of per frame.
+enum class ECameraNetRole : uint8
+{
+	// Another player's camera on a client, plays back replicated state.
+	Simulated,
+	// The local player's camera on a client, predicts input.
+	Owner,
+	// A remote player's camera on the server.
+	Authority,
+	// The host player's camera on a listen server.
+	AuthorityOwner
+};
+
+// Running totals of camera network messages, for stats and benchmarks.
+struct FCameraNetCounters
+{
+	// Owning client.
+	uint32 InputRpcsSent {0};
+	uint32 CorrectionsReceived {0};
+	uint32 ZoomSnapshotsSent {0};
+
+	// Server.
+	uint32 InputRpcsReceived {0};
+	uint32 AcksSent {0};
+	uint32 CorrectionsSent {0};
+};
+
+// Everything a remote client needs to play back a MoveTo or follow locally, replicated once per move.
 USTRUCT()
-struct FCameraMoveData
+struct FCameraMoveToDescriptor
 {
 	GENERATED_BODY()
 
 public:
-	float TimeStamp;	
-	FVector MoveToLocation;
-	FRotator MoveToRotation;
+	UPROPERTY()
+	FCameraNetState Start;
+
+	UPROPERTY()
+	FCameraNetState Destination;
+
+	// When set the destination tracks this actor instead.
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Target;
+
+	// When set the destination tracks the centroid of these actors instead.
+	UPROPERTY()
+	TArray<TWeakObjectPtr<AActor>> Group;
+
+	UPROPERTY()
+	double StartServerTime {0.0};
+
+	UPROPERTY()
+	float Duration {0.f};
+
+	UPROPERTY()
+	bool bActive {false};
 };
 
 UCLASS()
@@ -32,10 +89,30 @@ public:
 	ACRPG_PlayerCamera();
 
 protected:
+	virtual void OnConstruction(const FTransform& Transform) override;
+	
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void Tick(float DeltaSeconds) override;
 
+	virtual void OnRep_Owner() override;
+
+	/* --- BEGIN: Ticking --- */
+
+private:
+	ECameraNetRole CameraNetRole;
+
+	void UpdateCameraNetRole();
+
+	bool IsLocallyControlledCamera() const { return CameraNetRole == ECameraNetRole::Owner || CameraNetRole == ECameraNetRole::AuthorityOwner; }
+
+	// Enables tick only while a MoveTo, follow, correction or awake server state needs it.
+	void UpdateTickEnabled();
+
+	/* --- END: Ticking --- */
+
 	/* --- BEGIN: Components --- */
 	
 protected:
@@ -57,19 +134,165 @@ protected:
 
 public:
 	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+
+	uint32 GetMoveHistoryOverflowCount() const { return MoveHistory.GetOverflowCount(); }
+	int32 GetMoveHistoryHighWaterMark() const { return MoveHistory.GetHighWaterMark(); }
+	const FCameraNetCounters& GetNetCounters() const { return NetCounters; }
+
+	// Logs byte rates and camera ack/correction counts for every client connection. Server only.
+	static void DumpNetStats(UWorld* World);
+
+protected:
+	// Maximum number of unacknowledged predicted moves kept for reconciliation. Rounded up to a power of two.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="2"))
+	int32 MoveHistoryCapacity {64};
+
+	// Seconds without input, MoveTo or follow before the camera goes net dormant.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="0.1"))
+	float NetDormancyDelay {2.f};
+
+	// Net update frequency of a camera that is barely moving.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="1"))
+	float IdleNetUpdateFrequency {2.f};
+
+	// Net update frequency of a camera moving or rotating at full speed.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="1"))
+	float ActiveNetUpdateFrequency {10.f};
+
+	// Camera speed, in units per second, that replicates at ActiveNetUpdateFrequency.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="1"))
+	float MovementSpeedForActiveNetUpdateFrequency {1000.f};
+
+	// Camera rotation speed, in degrees per second, that replicates at ActiveNetUpdateFrequency.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="1"))
+	float RotationSpeedForActiveNetUpdateFrequency {90.f};
+
+	// Play other players' cameras back from buffered snapshots instead of snapping to each update.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking")
+	bool bInterpolateRemoteCameras {true};
+
+	// How far behind the server remote cameras are played back. Should cover two update intervals plus jitter.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="0", EditCondition="bInterpolateRemoteCameras"))
+	float SnapshotInterpolationDelay {0.25f};
+
+	// How long a remote camera keeps moving past its newest snapshot when updates are late.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="0", EditCondition="bInterpolateRemoteCameras"))
+	float SnapshotMaxExtrapolation {0.1f};
+
+	// Maximum number of buffered snapshots per remote camera. Rounded up to a power of two.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="2", EditCondition="bInterpolateRemoteCameras"))
+	int32 SnapshotBufferCapacity {16};
 	
 private:
 	
 	// Movement history to reconcile client-side prediction with server authority.
-	UPROPERTY()
-	TArray<FCameraMoveData> MoveHistory;
-	
-	// The index of the lowest MoveData the new corrections have come from.
-	int32 CorrectedIndex;
+	FCameraMoveHistory MoveHistory;
+
+	// Camera state for non-owning connections. Sent at the actor's NetUpdateFrequency rather than per input.
+	UPROPERTY(ReplicatedUsing=OnRep_ReplicatedState)
+	FCameraNetState ReplicatedState;
+
+	UFUNCTION()
+	void OnRep_ReplicatedState();
+
+	// Copies the server's camera transform into ReplicatedState.
+	void UpdateReplicatedState();
+
+	// Applies the fields set in a received state to the camera.
+	void ApplyNetState(const FCameraNetState& State);
+
+	// Wakes the camera from net dormancy and restarts the idle timer. Server only.
+	void MarkNetActive();
+
+	// Puts the camera to net dormancy if nothing is in flight, otherwise waits another NetDormancyDelay.
+	void TryEnterNetDormancy();
+
+	// Scales NetUpdateFrequency with how fast the camera has been moving. Server only.
+	void UpdateNetUpdateFrequency(float DeltaSeconds);
+
+	// Sets NetUpdateFrequency and passes it on to the replication graph, which otherwise keeps the class rate.
+	void ApplyNetUpdateFrequency(float Frequency);
+
+	// Re-stamps ReplicatedState once the camera stops so remote playback ends on a still snapshot. Server only.
+	void UpdateRestSnapshot();
+
+	// Whether ReplicatedState changed recently, and the frame it last changed on.
+	bool bReplicatedStateMoving;
+	uint64 ReplicatedStateFrame;
+
+	// Buffered ReplicatedState of a simulated camera.
+	FCameraSnapshotBuffer SnapshotBuffer;
+
+	bool ShouldInterpolateSnapshots() const;
+	void AddSnapshot(const FCameraNetState& State);
+	void TickSnapshotInterpolation();
+
+	// Whether playback has passed the newest snapshot and its extrapolation.
+	bool IsSnapshotPlaybackSettled() const;
+
+	FTimerHandle NetDormancyTimerHandle;
+
+	// Smoothed [0, 1] measure of recent camera motion and the transform it was last sampled from.
+	float NetMotionAlpha;
+	FVector LastNetMotionLocation;
+	float LastNetMotionYaw;
 
 	void NetworkSmoothing(float DeltaSeconds);
 
 	/* --- END: Networking --- */
+
+	/* --- BEGIN: Input --- */
+
+protected:
+	// How many frames of camera input are bundled into a single server RPC.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="1", ClampMax="8"))
+	int32 InputFramesPerPacket {1};
+
+	// Length of one input simulation sub-step. Client and server must agree on it for predictions to match.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Networking", meta=(ClampMin="0.001"))
+	float InputSimulationFixedStep {1.f / 60.f};
+
+public:
+	// Predicts and sends the camera input gathered this frame as one command. Called by the owning controller once input is processed.
+	void FlushCameraInput(float DeltaSeconds);
+
+protected:
+	// Server RPC to handle one or more frames of camera input, with the client's predicted result of the last one.
+	UFUNCTION(Server, Unreliable)
+	void SERVER_CameraInput(const FCameraInputCommandBatch& Batch, FCameraNetState ClientState);
+
+	// Client RPC confirming the owner's prediction up to the acknowledged sequence.
+	UFUNCTION(Client, Unreliable)
+	void CLIENT_AckCameraInput(FCameraNetState Ack);
+
+	// Client RPC sent instead of an ack when the owner's prediction diverged from the server.
+	UFUNCTION(Client, Unreliable)
+	void CLIENT_CorrectCameraInput(FCameraNetState Correction);
+
+	// Applies a command to the camera. Run by the client for prediction and by the server for authority.
+	void ApplyInputCommand(const FCameraInputCommand& Command);
+
+	FCameraSimulationSettings GetSimulationSettings() const;
+
+private:
+	// Input gathered since the last flush.
+	FVector2D PendingMoveInput;
+	float PendingRotateInput;
+	float PendingZoomInput;
+
+	// Commands waiting to be bundled into the next server RPC.
+	TArray<FCameraInputCommand> PendingInputCommands;
+
+	// The newest command sequence the server has applied.
+	uint32 LastAppliedInputSequence;
+
+	// Server time the owner's commands may still cover.
+	FCameraInputTimeBudget InputTimeBudget;
+
+	// Number of acks and corrections the server has sent to the owner.
+	FCameraNetCounters NetCounters;
+	
+	/* --- END: Input --- */
 	
 	/* --- BEGIN: Movement | Location --- */
 
@@ -87,30 +310,31 @@ private:
 	float NetworkedMovementDifference {1.f};
 	
 public:
-	// Move the camera based on player input (client prediction).
+	// Queue player movement input for this frame's camera command.
 	void MoveCamera(FVector2D MoveToLocation);
 
-protected:
-	// Server RPC to handle camera movement.
-	UFUNCTION(Server, Unreliable)
-	void SERVER_MoveCamera(FVector2D MoveToLocation, float TimeStamp);
-	
-	// Multicast RPC to update the camera position on all clients.
-	UFUNCTION(NetMulticast, Unreliable)
-	void MULTICAST_CorrectedMoveCamera(FVector CorrectPosition, float TimeStamp);
-
 private:
 	// Track whether the position is being corrected.
 	bool bPositionCorrected;
 	
-	// Client-predicted position for the camera.
-	FVector PredictedLocation;
-
 	// Server-authoritative position for the camera.
 	FVector ServerConfirmedLocation;
 	
 	/* --- END: Movement | Location --- */
 
+	/* --- BEGIN: Movement | Bounds --- */
+
+public:
+	// Where a move from From to To ends up inside the level's baked camera bounds. To when the level has none.
+	FVector ClampToCameraBounds(const FVector& From, const FVector& To) const;
+
+private:
+	// The level's legal camera region, found through its ACRPG_CameraBoundsVolume actors.
+	UPROPERTY(Transient)
+	TObjectPtr<UCRPG_CameraBoundsAsset> CameraBounds;
+
+	/* --- END: Movement | Bounds --- */
+
 	/* --- BEGIN: Movement | Rotation --- */
 
 protected:
@@ -127,25 +351,13 @@ protected:
 	float NetworkedRotationDifference {1.f};
 	
 public:
-	// Rotate the camera based on player input (client prediction).
+	// Queue player rotation input for this frame's camera command.
 	void RotateCamera(float MoveToRotation);
 
-protected:
-	// Server RPC to handle camera rotation.
-	UFUNCTION(Server, Unreliable)
-	void SERVER_RotateCamera(float MoveToRotation, float TimeStamp);
-	
-	// Multicast RPC to update the camera rotation on all clients.
-	UFUNCTION(NetMulticast, Unreliable)
-	void MULTICAST_CorrectedRotateCamera(FRotator CorrectRotation, float TimeStamp);
-
 private:
 	// Track whether the rotation is being corrected.
 	bool bRotationCorrected;
 	
-	// Client-predicted rotation for the camera.
-	FRotator PredictedRotation;
-
 	// Server-authoritative rotation for the camera.
 	FRotator ServerConfirmedRotation;
 
@@ -163,24 +375,126 @@ protected:
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="Camera Movement|Zoom")  
 	float ZoomSpeed{0.1f};
+
+	// Number of samples the zoom spline is baked into. Lookups interpolate between neighbouring samples.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Zoom", meta=(ClampMin="2"))
+	int32 ZoomSplineTableResolution{128};
+
+	// Zoom is cosmetic: simulate it on the owning client only and send spectators a throttled snapshot instead of per-frame input.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Zoom")
+	bool bClientAuthoritativeZoom{true};
+
+	// Minimum seconds between zoom snapshots sent by the owning client.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Zoom", meta=(ClampMin="0", EditCondition="bClientAuthoritativeZoom"))
+	float ZoomSnapshotInterval{0.25f};
 	
 public:
+	// Queue player zoom input for this frame's camera command.
 	void ZoomCamera(float InputZoom);
+
+	// Position along the zoom spline, 0 closest to the focus and 1 farthest from it.
+	float GetZoomPercent() const { return ZoomPercent; }
+
+	// Logs the per-call cost of evaluating the zoom spline directly against the baked table.
+	static void BenchmarkZoomSpline(UWorld* World);
   
 protected:
-	UFUNCTION(Server, Unreliable)
-	void SERVER_ZoomCamera(float InputZoom);
-
 	UFUNCTION(NetMulticast, Unreliable)
-	void MULTICAST_ZoomCamera(float NewZoomPercent);
+	void MULTICAST_ZoomCamera(FCameraNetState ZoomState);
+
+	// Latest zoom of the owning client, only used with bClientAuthoritativeZoom.
+	UFUNCTION(Server, Reliable)
+	void SERVER_ZoomSnapshot(FCameraNetState ZoomState);
+
+	// Sends the owner's zoom to the server when it changed and ZoomSnapshotInterval has passed.
+	void SendZoomSnapshot();
+
+	// Passes the server's zoom on to spectators through ReplicatedState, or MULTICAST_ZoomCamera without bClientAuthoritativeZoom.
+	void ReplicateZoom();
 	
 	void SetCameraTransformAlongSpline(float ZoomPercentage) const;  
+
+	// Samples the zoom spline into the spring arm's parent space so a zoom is a single relative transform write.
+	void BakeZoomSplineTable();
+
   
 private:
 	float ZoomPercent;
+
+	FCameraNetState LastZoomSnapshot;
+	double LastZoomSnapshotTime;
+
+	// Spring arm relative transforms along the zoom spline.
+	FCameraZoomTable ZoomTable;
 	
 	/* --- END: Movement | Zoom --- */
 
+	/* --- BEGIN: Movement | Terrain --- */
+
+protected:
+	// Raise and lower the view with the ground under the focus point instead of keeping it on the camera's plane.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain")
+	bool bFollowTerrain {true};
+
+	// Object type of the geometry the camera follows.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(EditCondition="bFollowTerrain"))
+	TEnumAsByte<ECollisionChannel> TerrainObjectType {ECC_WorldStatic};
+
+	// Spacing of the cached ground heights.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(ClampMin="10", EditCondition="bFollowTerrain"))
+	float TerrainCellSize {200.f};
+
+	// Width of the height cache in grid points. Must cover the points around the focus and the look ahead.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(ClampMin="4", EditCondition="bFollowTerrain"))
+	int32 TerrainCacheDimension {16};
+
+	// Seconds of camera motion ahead of the focus point to trace before the camera gets there.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(ClampMin="0", EditCondition="bFollowTerrain"))
+	float TerrainTraceLookAhead {0.5f};
+
+	// How far above and below the camera's plane ground is searched for. Keep TerrainTraceUp below the floor above in multi-level maps.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(ClampMin="0", EditCondition="bFollowTerrain"))
+	float TerrainTraceUp {1000.f};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(ClampMin="0", EditCondition="bFollowTerrain"))
+	float TerrainTraceDown {5000.f};
+
+	// Most async traces issued in one frame.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(ClampMin="1", EditCondition="bFollowTerrain"))
+	int32 MaxTerrainTracesPerFrame {16};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Terrain", meta=(ClampMin="0", EditCondition="bFollowTerrain"))
+	float TerrainHeightInterpSpeed {5.f};
+
+public:
+	// Traces ahead of the camera and eases the view onto the cached ground height. Called by the owning controller every frame.
+	void TickTerrainFollow(float DeltaSeconds);
+
+	float GetTerrainCacheHitRate() const { return TerrainHeightField.GetHitRate(); }
+
+private:
+	// Ground heights around the focus point.
+	FCameraHeightField TerrainHeightField;
+
+	FTraceDelegate TerrainTraceDelegate;
+
+	// Height of the ground under the focus relative to the camera's plane, applied to the spring arm.
+	float TerrainHeightOffset;
+	float TargetTerrainHeightOffset;
+
+	// Plane height the cache was traced from, and the focus point last frame.
+	float TerrainCacheZ;
+	FVector LastTerrainFocus;
+
+	int32 TerrainTracesThisFrame;
+
+	// Issues traces for the uncached grid points around Location, within this frame's budget.
+	void RequestTerrainTraces(const FVector& Location);
+
+	void OnTerrainTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/* --- END: Movement | Terrain --- */
+
 	/* --- BEGIN: Movement | Move To --- */
 
 protected:
@@ -210,12 +524,17 @@ protected:
 		
 	// Tick the movement over time.
 	void MoveToDestination(float DeltaSeconds);
-	
-	// Tick the movement over time for clients
-	UFUNCTION(NetMulticast, Unreliable)
-	void MULTICAST_MoveToDestination(FTransform NewTransform);	
+
+	UFUNCTION()
+	void OnRep_MoveToDescriptor();
+
+	double GetServerWorldTimeSeconds() const;
 	
 private:
+	// The server's current move, evaluated locally by non-owning clients.
+	UPROPERTY(ReplicatedUsing=OnRep_MoveToDescriptor)
+	FCameraMoveToDescriptor MoveToDescriptor;
+	
 	bool bMovingToDestination;
 	FTransform CameraDestination;	
 
@@ -233,14 +552,111 @@ public:
 	bool IsFollowingTarget() const { return bIsFollowingTarget; };
 	bool IsFollowingTarget(const AActor* ActorToFollow) const { return bIsFollowingTarget && ActorToFollow == TargetToFollow; };
 
+	// Follows the centroid of a group, zooming along the zoom spline so every member stays in view.
+	void FollowGroup(const TArray<AActor*>& ActorsToFollow, bool bLockRotation = false);
+	bool IsFollowingGroup() const { return bIsFollowingTarget && !GroupHandles.IsEmpty(); }
+
 protected:
+	// Seconds ahead of the followed actor, along its velocity, that the camera aims for.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Follow Target", meta=(ClampMin="0"))
+	float FollowVelocityLead {0.f};
+
+	// Scale on the group's radius when picking a zoom that fits it, leaving room around the outermost members.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Follow Target", meta=(ClampMin="1"))
+	float GroupFramingMargin {1.25f};
+
+	// How fast the zoom eases towards the one that fits the group.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Follow Target", meta=(ClampMin="0"))
+	float GroupZoomInterpSpeed {2.f};
+	
 	void TickFollowTarget(float DeltaTime);
+
+	void TickFollowGroup(float DeltaTime);
 	
 private:
 	bool bIsFollowingTarget;
 	TWeakObjectPtr<AActor> TargetToFollow;
+
+	// Handle of TargetToFollow in the world's UCRPG_TrackedActorSubsystem.
+	int32 FollowTargetHandle;
+
+	// Members of the followed group and their handles in the world's UCRPG_TrackedActorSubsystem.
+	TArray<TWeakObjectPtr<AActor>> GroupToFollow;
+	TArray<int32> GroupHandles;
+
+	// Group positions relative to the camera, gathered each frame for CameraFraming::ComputeBounds.
+	TArray<FVector4f> GroupPositions;
+
+	// Swaps the tracked target, nullptr stops following.
+	void SetTargetToFollow(AActor* NewTarget);
+
+	// Swaps the tracked group, an empty group stops following.
+	void SetGroupToFollow(const TArray<TWeakObjectPtr<AActor>>& NewGroup);
+
+	// Releases every handle taken for the current target or group.
+	void ReleaseFollowHandles();
 	
 	
 	/* --- END: Movement | Follow Target --- */
+
+	/* --- BEGIN: Movement | Commands --- */
+
+protected:
+	// Longest command sequence a client may submit.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Commands", meta=(ClampMin="1"))
+	int32 MaxCameraCommands {32};
+
+	// Seconds a sequence is scheduled ahead of the server's clock, so remote machines receive it before it starts.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Camera Movement|Commands", meta=(ClampMin="0"))
+	float CameraCommandStartDelay {0.1f};
+
+public:
+	// Plays a scripted sequence of MoveTo, Follow, Zoom and Hold steps, replacing any MoveTo, follow or previous sequence.
+	// The whole sequence is sent once and every machine plays it back against server time.
+	void PlayCameraCommands(const TArray<FCameraCommand>& Commands);
+
+	// Stops the sequence, leaving the camera where it is.
+	void StopCameraCommands();
+
+	bool IsPlayingCameraCommands() const { return CameraCommandIndex != INDEX_NONE; }
+
+protected:
+	UFUNCTION(Server, Reliable, WithValidation)
+	void SERVER_PlayCameraCommands(const TArray<FCameraCommand>& Commands);
+
+	UFUNCTION(Server, Reliable)
+	void SERVER_StopCameraCommands();
+
+	UFUNCTION()
+	void OnRep_CameraCommandSchedule();
+
+	// Advances the sequence to the current server time.
+	void TickCameraCommands();
+	
+private:
+	UPROPERTY(ReplicatedUsing=OnRep_CameraCommandSchedule)
+	FCameraCommandSchedule CameraCommandSchedule;
+
+	// The step being played, INDEX_NONE when no sequence is.
+	int32 CameraCommandIndex;
+
+	// Seconds into the sequence the current step started, and the camera state it started from.
+	double CameraCommandStepStartTime;
+	FTransform CameraCommandStartTransform;
+	float CameraCommandStartZoomPercent;
+
+	// Starts playing CameraCommandSchedule from its first step.
+	void BeginCameraCommands();
+
+	// Stops playback. On the server this also ends the replicated schedule and settles remote cameras.
+	void EndCameraCommands();
+
+	// Captures the camera state the current step eases from.
+	void BeginCameraCommandStep();
+
+	// Poses the camera Alpha of the way through Command.
+	void ApplyCameraCommand(const FCameraCommand& Command, float Alpha);
+
+	/* --- END: Movement | Commands --- */
 };
 
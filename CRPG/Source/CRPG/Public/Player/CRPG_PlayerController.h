@@ -8,6 +8,7 @@
 #include "CRPG_PlayerController.generated.h"
 
 class ACRPG_PlayerCamera;
+class UCRPG_CursorHitService;
 class UCRPG_TacticalInputDataAsset;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCRPGPlayerController, Log, All);
@@ -57,6 +58,9 @@ protected:
 	void CameraRotateInput(const FInputActionValue& Input);
 	void CameraZoomInput(const FInputActionValue& Input);
 	void CameraLockInput(const FInputActionValue& Input);
+
+public:
+	virtual void PlayerTick(float DeltaTime) override;
 	
 	/* --- END: Camera Input --- */
 
@@ -73,6 +77,12 @@ private:
 public:
 	virtual void AutoManageActiveCameraTarget(AActor* SuggestedTarget) override;
 
+	// On the server, remote players view from their camera's focus rather than the elevated camera. Relevancy and
+	// the replication graph's spatial cells are measured from here.
+	virtual void GetPlayerViewPoint(FVector& OutLocation, FRotator& OutRotation) const override;
+
+	ACRPG_PlayerCamera* GetPlayerCamera() const { return PlayerCamera; }
+
 private:
 	void SetPlayerCamera();
 
@@ -93,14 +103,89 @@ protected:
 	bool bBlockingCameraInput;
 	
 public:
+	bool IsLockedToTarget() const { return bIsLockedToTarget; }
+	
 	void LockCameraToTarget(AActor* ActorToTarget, bool bTargetBlocksCameraInput = false);
+
+	// Locks the camera onto a whole group, such as the selected party, framing all of it.
+	void LockCameraToGroup(const TArray<AActor*>& ActorsToTarget, bool bTargetBlocksCameraInput = false);
+	
 	void UnlockCamera(bool bUnblockCameraInput = true);
 
 	UFUNCTION(Server, Reliable)
 	void SERVER_LockCameraToTarget(AActor* ActorToTarget, bool bTargetBlocksCameraInput = false);
 
+	UFUNCTION(Server, Reliable)
+	void SERVER_LockCameraToGroup(const TArray<AActor*>& ActorsToTarget, bool bTargetBlocksCameraInput = false);
+
 	UFUNCTION(Server, Reliable)
 	void SERVER_UnlockCamera(bool bUnblockCameraInput = true);
 			
 	/* --- END: Camera Attachment --- */
+
+	/* --- BEGIN: Selection --- */
+
+private:
+	// The one cursor trace per frame every hover, selection and preview system reads.
+	UPROPERTY(VisibleAnywhere, Category="Selection")
+	TObjectPtr<UCRPG_CursorHitService> CursorHitService;
+
+	TArray<TWeakObjectPtr<AActor>> SelectedActors;
+
+	// How far in pixels the cursor has to move while Select is held before it becomes a marquee.
+	UPROPERTY(EditDefaultsOnly, Category="Selection")
+	float MarqueeDragThreshold {8.f};
+
+	bool bSelectPressed;
+	bool bMarqueeActive;
+	FVector2D MarqueeStart;
+	FVector2D MarqueeEnd;
+
+	// What the marquee currently covers, committed to SelectedActors on release.
+	TArray<TWeakObjectPtr<AActor>> MarqueeActors;
+
+protected:
+	void SelectInput(const FInputActionValue& Input);
+	void SelectReleasedInput(const FInputActionValue& Input);
+
+	void TickMarquee();
+
+public:
+	UCRPG_CursorHitService* GetCursorHitService() const { return CursorHitService; }
+
+	const TArray<TWeakObjectPtr<AActor>>& GetSelectedActors() const { return SelectedActors; }
+
+	bool IsMarqueeActive() const { return bMarqueeActive; }
+
+	// Screen rectangle of the marquee being dragged, for the HUD to draw. False when there is none.
+	bool GetMarqueeRect(FVector2D& OutMin, FVector2D& OutMax) const;
+
+	const TArray<TWeakObjectPtr<AActor>>& GetMarqueeActors() const { return MarqueeActors; }
+	
+	/* --- END: Selection --- */
+
+	/* --- BEGIN: Party Movement --- */
+
+protected:
+	void MoveSelectedInput(const FInputActionValue& Input);
+
+public:
+	// Moves the selected pawns to formation slots around Destination.
+	void MoveSelectedActorsTo(const FVector& Destination);
+
+	// Moves Members to formation slots around Destination, on the server since that is where characters move.
+	void MovePartyTo(const TArray<APawn*>& Members, const FVector& Destination);
+
+	// Whether this player may order Member around: it must be possessed by this controller or be a character in this
+	// player's party, see ACRPG_BaseCharacter::GetOwningPlayerState.
+	bool CanOrderMember(const APawn* Member) const;
+
+	// Most members a client can order at once. Larger orders are rejected.
+	static constexpr int32 MaxPartyOrderMembers = 32;
+
+	// Members this controller can't order are dropped.
+	UFUNCTION(Server, Reliable, WithValidation)
+	void SERVER_MovePartyTo(const TArray<APawn*>& Members, FVector_NetQuantize Destination);
+
+	/* --- END: Party Movement --- */
 };
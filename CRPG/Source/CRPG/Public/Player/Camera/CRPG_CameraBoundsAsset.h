@@ -0,0 +1,52 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CRPG_CameraBoundsAsset.generated.h"
+
+class AVolume;
+
+/**
+ * A level's legal camera region baked into a 2D occupancy grid, one bit per cell.
+ * Client and server clamp against the same grid, so they agree on the camera's location without any physics query.
+ * Baked in the editor from the level's ACRPG_CameraBoundsVolume actors.
+ */
+UCLASS()
+class CRPG_API UCRPG_CameraBoundsAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	bool IsBaked() const { return Dimensions.X > 0 && Dimensions.Y > 0; }
+
+	// Whether Location's cell is inside the legal region. Outside the grid is never legal.
+	bool IsLegal(const FVector& Location) const;
+
+	// To if it is legal, otherwise To slid along whichever axis stays legal, otherwise From.
+	// A camera already outside the region moves freely so it can never get stuck.
+	FVector Clamp(const FVector& From, const FVector& To) const;
+
+#if WITH_EDITOR
+	// Rebuilds the grid over the XY bounds of Volumes, marking cells whose centers any of them contains.
+	void Bake(TConstArrayView<const AVolume*> Volumes);
+#endif
+
+protected:
+	// Size of a grid cell. Smaller cells follow the volumes more closely at four times the memory per halving.
+	UPROPERTY(EditAnywhere, Category="Bake", meta=(ClampMin="10"))
+	float CellSize {100.f};
+
+private:
+	// World XY of the grid's lower corner.
+	UPROPERTY(VisibleAnywhere, Category="Bake")
+	FVector2D Origin {FVector2D::ZeroVector};
+
+	UPROPERTY(VisibleAnywhere, Category="Bake")
+	FIntPoint Dimensions {0, 0};
+
+	// Row-major cells, eight to a byte.
+	UPROPERTY()
+	TArray<uint8> Cells;
+};
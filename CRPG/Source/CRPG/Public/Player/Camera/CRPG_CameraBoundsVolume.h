@@ -0,0 +1,34 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Volume.h"
+#include "CRPG_CameraBoundsVolume.generated.h"
+
+class UCRPG_CameraBoundsAsset;
+
+/**
+ * Marks part of a level as legal for the tactical camera. The union of a level's volumes is baked into
+ * BoundsAsset in the editor, the camera only ever reads the baked grid.
+ */
+UCLASS()
+class CRPG_API ACRPG_CameraBoundsVolume : public AVolume
+{
+	GENERATED_BODY()
+
+public:
+	ACRPG_CameraBoundsVolume();
+
+	UCRPG_CameraBoundsAsset* GetBoundsAsset() const { return BoundsAsset; }
+
+#if WITH_EDITOR
+	// Bakes every camera bounds volume in this level that shares BoundsAsset into it. Save the asset afterwards.
+	UFUNCTION(CallInEditor, Category="Camera Bounds")
+	void BakeCameraBounds();
+#endif
+
+protected:
+	UPROPERTY(EditInstanceOnly, Category="Camera Bounds")
+	TObjectPtr<UCRPG_CameraBoundsAsset> BoundsAsset;
+};
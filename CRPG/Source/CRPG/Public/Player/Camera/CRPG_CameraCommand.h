@@ -0,0 +1,80 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Player/Camera/CRPG_CameraEasing.h"
+#include "Player/Camera/CRPG_CameraNetState.h"
+#include "CRPG_CameraCommand.generated.h"
+
+UENUM()
+enum class ECameraCommandType : uint8
+{
+	// Ease to a location and yaw.
+	MoveTo,
+	// Ease onto an actor, tracking it for the whole step.
+	Follow,
+	// Ease to a zoom percent.
+	Zoom,
+	// Keep the camera where it is.
+	Hold
+};
+
+// One step of a scripted camera sequence.
+USTRUCT()
+struct CRPG_API FCameraCommand
+{
+	GENERATED_BODY()
+
+public:
+	static FCameraCommand MakeMoveTo(const FTransform& Destination, float StepDuration, ECameraEasing StepEasing = ECameraEasing::CubicInOut);
+	static FCameraCommand MakeFollow(AActor* ActorToFollow, float StepDuration, ECameraEasing StepEasing = ECameraEasing::CubicInOut);
+	static FCameraCommand MakeZoom(float ZoomPercent, float StepDuration, ECameraEasing StepEasing = ECameraEasing::CubicInOut);
+	static FCameraCommand MakeHold(float StepDuration);
+
+	// Longest step a client may request.
+	static constexpr float MaxDuration = 60.f;
+
+	// Whether the type, easing and duration are in range and the step carries what its type needs. For commands
+	// received from clients.
+	bool IsValid() const;
+
+	UPROPERTY()
+	ECameraCommandType Type {ECameraCommandType::Hold};
+
+	UPROPERTY()
+	ECameraEasing Easing {ECameraEasing::Linear};
+
+	// Seconds the step takes.
+	UPROPERTY()
+	float Duration {0.f};
+
+	// Destination of MoveTo, or zoom percent of Zoom.
+	UPROPERTY()
+	FCameraNetState State;
+
+	// Actor a Follow step eases onto.
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Target;
+};
+
+// A camera command sequence scheduled against server time, so every machine plays it back without further messages.
+USTRUCT()
+struct CRPG_API FCameraCommandSchedule
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<FCameraCommand> Commands;
+
+	// Server time the first step starts at.
+	UPROPERTY()
+	double StartServerTime {0.0};
+
+	UPROPERTY()
+	bool bActive {false};
+
+	// Seconds the whole sequence takes.
+	float GetDuration() const;
+};
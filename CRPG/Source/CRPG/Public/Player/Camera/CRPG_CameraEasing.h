@@ -0,0 +1,100 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CRPG_CameraEasing.generated.h"
+
+// Easing curve of a camera command step. Replicated, so new curves go at the end.
+UENUM()
+enum class ECameraEasing : uint8
+{
+	Linear,
+	SineInOut,
+	QuadIn,
+	QuadOut,
+	QuadInOut,
+	CubicIn,
+	CubicOut,
+	CubicInOut
+};
+
+/**
+ * Easing curves specialized per ECameraEasing at compile time, so code that knows its curve calls it directly and
+ * Evaluate's switch jumps straight into an inlined curve for replicated data. Alpha is expected in [0, 1].
+ */
+namespace CameraEasing
+{
+	template<ECameraEasing Easing>
+	float Ease(float Alpha);
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::Linear>(float Alpha)
+	{
+		return Alpha;
+	}
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::SineInOut>(float Alpha)
+	{
+		return 0.5f - 0.5f * FMath::Cos(Alpha * UE_PI);
+	}
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::QuadIn>(float Alpha)
+	{
+		return Alpha * Alpha;
+	}
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::QuadOut>(float Alpha)
+	{
+		const float Inverse = 1.f - Alpha;
+		return 1.f - Inverse * Inverse;
+	}
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::QuadInOut>(float Alpha)
+	{
+		const float Inverse = -2.f * Alpha + 2.f;
+		return Alpha < 0.5f ? 2.f * Alpha * Alpha : 1.f - Inverse * Inverse * 0.5f;
+	}
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::CubicIn>(float Alpha)
+	{
+		return Alpha * Alpha * Alpha;
+	}
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::CubicOut>(float Alpha)
+	{
+		const float Inverse = 1.f - Alpha;
+		return 1.f - Inverse * Inverse * Inverse;
+	}
+
+	template<>
+	FORCEINLINE float Ease<ECameraEasing::CubicInOut>(float Alpha)
+	{
+		const float Inverse = -2.f * Alpha + 2.f;
+		return Alpha < 0.5f ? 4.f * Alpha * Alpha * Alpha : 1.f - Inverse * Inverse * Inverse * 0.5f;
+	}
+
+	// Runtime dispatch for an easing only known from data. Clamps Alpha to [0, 1].
+	FORCEINLINE float Evaluate(ECameraEasing Easing, float Alpha)
+	{
+		Alpha = FMath::Clamp(Alpha, 0.f, 1.f);
+		
+		switch (Easing)
+		{
+		case ECameraEasing::SineInOut:	return Ease<ECameraEasing::SineInOut>(Alpha);
+		case ECameraEasing::QuadIn:		return Ease<ECameraEasing::QuadIn>(Alpha);
+		case ECameraEasing::QuadOut:	return Ease<ECameraEasing::QuadOut>(Alpha);
+		case ECameraEasing::QuadInOut:	return Ease<ECameraEasing::QuadInOut>(Alpha);
+		case ECameraEasing::CubicIn:	return Ease<ECameraEasing::CubicIn>(Alpha);
+		case ECameraEasing::CubicOut:	return Ease<ECameraEasing::CubicOut>(Alpha);
+		case ECameraEasing::CubicInOut:	return Ease<ECameraEasing::CubicInOut>(Alpha);
+		default:						return Ease<ECameraEasing::Linear>(Alpha);
+		}
+	}
+}
@@ -0,0 +1,30 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Centroid and axis-aligned bounds of a group of points.
+struct FCameraGroupBounds
+{
+	FVector3f Centroid {FVector3f::ZeroVector};
+	FVector3f Min {FVector3f::ZeroVector};
+	FVector3f Max {FVector3f::ZeroVector};
+
+	// Distance in the XY plane from Center to the farthest corner of the bounds.
+	CRPG_API float GetPlanarRadius(const FVector3f& Center) const;
+};
+
+/**
+ * Group framing kernels for following several actors at once.
+ * Positions are packed as FVector4f so every point is one SIMD register; W is ignored. Callers should store them
+ * relative to a nearby origin so the float lanes keep their precision far from the world origin.
+ */
+namespace CameraFraming
+{
+	// Vectorized centroid and bounds. Returns zeroed bounds for an empty group.
+	CRPG_API FCameraGroupBounds ComputeBounds(TConstArrayView<FVector4f> Positions);
+
+	// Scalar equivalent of ComputeBounds, kept as a reference for the kernel benchmark.
+	CRPG_API FCameraGroupBounds ComputeBoundsScalar(TConstArrayView<FVector4f> Positions);
+}
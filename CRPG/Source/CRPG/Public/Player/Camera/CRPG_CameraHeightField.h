@@ -0,0 +1,78 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Small cache of ground heights on a regular grid around the camera's focus point, filled by async traces.
+ * Grid points wrap around a fixed Dimension x Dimension array, so points the camera moved away from are
+ * overwritten by the ones it moves towards and the cache never grows or reallocates.
+ */
+struct CRPG_API FCameraHeightField
+{
+public:
+	void Init(int32 InDimension, float InCellSize);
+
+	// Forgets every cached height and starts a new generation. Results of traces still in flight are dropped when they
+	// arrive, even if their slot was claimed again since.
+	void Reset();
+
+	// Changes on every Reset. Pass it along with a trace and back to Store.
+	uint32 GetGeneration() const { return Generation; }
+
+	bool IsInitialized() const { return !Slots.IsEmpty(); }
+	float GetCellSize() const { return CellSize; }
+
+	// Grid point at the lower corner of the cell containing Location.
+	FIntPoint GetCell(const FVector& Location) const;
+
+	// Grid point closest to Location.
+	FIntPoint GetNearestPoint(const FVector& Location) const;
+
+	// World XY of a grid point.
+	FVector2D GetPointLocation(const FIntPoint& Point) const { return FVector2D(Point) * CellSize; }
+
+	// Whether Point is neither cached nor waiting on a trace.
+	bool NeedsTrace(const FIntPoint& Point) const;
+
+	// Claims Point's slot for a trace in flight, in the current generation.
+	void MarkPending(const FIntPoint& Point);
+
+	// Stores a trace result, unless Point's slot was reset or claimed by another point since it was requested in
+	// TraceGeneration.
+	void Store(const FIntPoint& Point, uint32 TraceGeneration, TOptional<float> Height);
+
+	// Height at Location interpolated from the four surrounding grid points. Counts as a hit when they are all traced.
+	bool SampleHeight(const FVector& Location, float& OutHeight);
+
+	// Fraction of SampleHeight calls answered from the cache.
+	float GetHitRate() const { return Hits + Misses > 0 ? static_cast<float>(static_cast<double>(Hits) / (Hits + Misses)) : 0.f; }
+
+private:
+	enum class ESlotState : uint8
+	{
+		Empty,
+		Pending,
+		Ground,
+		NoGround
+	};
+
+	struct FSlot
+	{
+		FIntPoint Point {0, 0};
+		float Height {0.f};
+		uint32 Generation {0};
+		ESlotState State {ESlotState::Empty};
+	};
+
+	int32 GetSlotIndex(const FIntPoint& Point) const;
+
+	TArray<FSlot> Slots;
+	int32 Dimension {0};
+	float CellSize {1.f};
+	uint32 Generation {0};
+
+	uint64 Hits {0};
+	uint64 Misses {0};
+};
@@ -0,0 +1,131 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CRPG_CameraInputCommand.generated.h"
+
+/**
+ * One frame of camera input packed and quantized for the network.
+ * The owning client predicts with the dequantized values so it simulates exactly what the server receives.
+ */
+USTRUCT()
+struct CRPG_API FCameraInputCommand
+{
+	GENERATED_BODY()
+
+public:
+	// Sequence number of the predicted move this command produced. Only the low 16 bits are sent.
+	uint32 Sequence {0};
+	
+	// Move axes in the range [-1, 1], quantized to 1/127.
+	int8 MoveX {0};
+	int8 MoveY {0};
+
+	// Rotation and zoom input, quantized to 1/1024.
+	int16 Yaw {0};
+	int16 Zoom {0};
+
+	// Frame time the input was applied over, quantized to 1/10000 of a second.
+	uint16 DeltaTime {0};
+
+	void SetMove(const FVector2D& Input);
+	void SetYaw(float Input);
+	void SetZoom(float Input);
+	void SetDeltaSeconds(float DeltaSeconds);
+
+	FVector2D GetMove() const { return FVector2D(MoveX / MoveScale, MoveY / MoveScale); }
+	float GetYaw() const { return Yaw / AxisScale; }
+	float GetZoom() const { return Zoom / AxisScale; }
+	float GetDeltaSeconds() const { return static_cast<float>(DeltaTime) / DeltaTimeScale; }
+
+	bool HasMove() const { return MoveX != 0 || MoveY != 0; }
+	bool HasYaw() const { return Yaw != 0; }
+	bool HasZoom() const { return Zoom != 0; }
+	bool IsEmpty() const { return !HasMove() && !HasYaw() && !HasZoom(); }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	// Serializes everything but the sequence, which the caller writes in whatever form suits it.
+	void SerializePayload(FArchive& Ar);
+
+	// DeltaTime units per second.
+	static constexpr int32 DeltaTimeScale = 10000;
+
+private:
+	static constexpr float MoveScale = 127.f;
+	static constexpr float AxisScale = 1024.f;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCameraInputCommand> : public TStructOpsTypeTraitsBase2<FCameraInputCommand>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/**
+ * Several frames of camera input sent in one RPC.
+ * Only the first command's sequence is sent as its low 16 bits. Each following command costs a single bit when its
+ * sequence directly follows the previous one, which is the common case, and a packed delta otherwise.
+ */
+USTRUCT()
+struct CRPG_API FCameraInputCommandBatch
+{
+	GENERATED_BODY()
+
+public:
+	TArray<FCameraInputCommand> Commands;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	// Upper bound on commands per batch. Larger batches are truncated when sent and rejected when received.
+	static constexpr int32 MaxCommands = 32;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCameraInputCommandBatch> : public TStructOpsTypeTraitsBase2<FCameraInputCommandBatch>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/**
+ * Server-side cap on how much time a client's camera input may cover, so a client claiming long frames can't move its
+ * camera faster than its speed allows. Each command covers at most MaxCommandSeconds, and all commands together at most
+ * the server time that passed, plus up to MaxBankedSeconds saved up to absorb packets arriving in bursts.
+ * Kept on the command time base so it never drifts from the commands it limits.
+ */
+struct CRPG_API FCameraInputTimeBudget
+{
+public:
+	// Grants the server time passed since the previous call. The first call grants a full bank.
+	void Refill(double ServerTimeSeconds);
+
+	// Cuts Command's frame time down to what it may cover and spends it. Returns true if it had to be cut.
+	bool Spend(FCameraInputCommand& Command);
+
+	float GetRemainingSeconds() const { return static_cast<float>(RemainingTicks) / FCameraInputCommand::DeltaTimeScale; }
+
+	static constexpr float MaxCommandSeconds = 0.25f;
+	static constexpr float MaxBankedSeconds = 1.f;
+
+private:
+	double LastRefillTime {0.0};
+	int32 RemainingTicks {0};
+	bool bStarted {false};
+};
+
+namespace CameraNet
+{
+	/**
+	 * The server's handling of a received batch: resolves every command's sequence against LastAppliedSequence, drops
+	 * duplicated and out of order commands, cuts frame times down to Budget and calls Apply with each command left, oldest
+	 * first. Returns the number of commands whose frame time was cut.
+	 */
+	CRPG_API int32 AcceptInputCommands(const FCameraInputCommandBatch& Batch, uint32& LastAppliedSequence, FCameraInputTimeBudget& Budget, TFunctionRef<void(const FCameraInputCommand&)> Apply);
+}
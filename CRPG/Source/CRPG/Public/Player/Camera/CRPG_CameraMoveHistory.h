@@ -0,0 +1,68 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CRPG_CameraMoveHistory.generated.h"
+
+USTRUCT()
+struct FCameraMoveData
+{
+	GENERATED_BODY()
+
+public:
+	// Sequence number of the move, shared by all input predicted in the same frame.
+	uint32 Sequence {0};
+	FVector MoveToLocation {FVector::ZeroVector};
+	FRotator MoveToRotation {FRotator::ZeroRotator};
+};
+
+/**
+ * Fixed-capacity ring buffer of predicted camera moves keyed by a monotonically increasing sequence number.
+ * Insert, lookup and acknowledgement are O(1). When full the oldest unacknowledged move is dropped and counted.
+ */
+struct CRPG_API FCameraMoveHistory
+{
+public:
+	// Allocates the buffer. Capacity is rounded up to a power of two.
+	void Init(int32 InCapacity);
+
+	// Drops every stored move. Sequence numbers keep counting so late acknowledgements can't match new moves.
+	void Reset();
+
+	// Appends a new move with the next sequence number, overwriting the oldest one if the buffer is full.
+	FCameraMoveData& Add();
+
+	// Returns the move with this sequence number, or nullptr if it was acknowledged, dropped or never recorded.
+	FCameraMoveData* Find(uint32 Sequence);
+
+	// Returns the most recently added move, or nullptr if the buffer is empty.
+	FCameraMoveData* GetNewest();
+
+	// Drops the move with this sequence number and every older move.
+	void Acknowledge(uint32 Sequence);
+
+	int32 Num() const { return static_cast<int32>(NextSequence - OldestSequence); }
+	int32 GetCapacity() const { return Moves.Num(); }
+	uint32 GetNextSequence() const { return NextSequence; }
+	bool IsEmpty() const { return NextSequence == OldestSequence; }
+
+	// Number of moves dropped because the buffer was full before the server acknowledged them.
+	uint32 GetOverflowCount() const { return OverflowCount; }
+
+	// Largest number of unacknowledged moves held at once.
+	int32 GetHighWaterMark() const { return HighWaterMark; }
+
+private:
+	bool Contains(uint32 Sequence) const;
+
+	TArray<FCameraMoveData> Moves;
+	uint32 IndexMask {0};
+
+	// Sequence 0 is reserved to mean "no move".
+	uint32 OldestSequence {1};
+	uint32 NextSequence {1};
+
+	uint32 OverflowCount {0};
+	int32 HighWaterMark {0};
+};
@@ -0,0 +1,113 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "CRPG_CameraNetState.generated.h"
+
+/**
+ * Packed camera state used by every camera RPC and replicated property.
+ * Only the fields that were set are written. Values are stored quantized so sender and receiver see the same numbers:
+ * - Location to 0.1 units, well inside the default NetworkedMovementDifference of 1. Z is kept even though input only
+ *   moves the camera across the ground plane, because MoveTo, group follow and terrain follow all change its height.
+ *   Each axis is an absolute value, zig-zag packed 7 bits per byte: one byte within 6.4 units of the origin, two
+ *   within 819.2 and three within about 104857, so a typical ground height costs two or three bytes.
+ * - Yaw to 16 bits (~0.0055 degrees), well inside the default NetworkedRotationDifference of 1.
+ * - Zoom percent to 8 bits.
+ * - The move sequence as its low 16 bits, resolved against a sequence the receiver already knows.
+ * - The server time in milliseconds as its low 16 bits, resolved against the receiver's estimate of server time.
+ */
+USTRUCT()
+struct CRPG_API FCameraNetState
+{
+	GENERATED_BODY()
+
+public:
+	void SetLocation(const FVector& Location);
+	void SetYaw(float Yaw);
+	void SetZoomPercent(float ZoomPercent);
+	void SetSequence(uint32 Sequence);
+	void SetServerTime(double ServerTimeSeconds);
+	void SetTransform(const FTransform& Transform);
+
+	FVector GetLocation() const;
+	float GetYaw() const;
+	float GetZoomPercent() const;
+	FTransform GetTransform() const;
+
+	// Returns the full sequence number closest to Reference, which must be within 32767 moves of the sent sequence.
+	uint32 ResolveSequence(uint32 Reference) const;
+
+	// Returns the server time in seconds closest to Reference, which must be within 32 seconds of the sent time.
+	double ResolveServerTime(double ReferenceSeconds) const;
+
+	bool HasLocation() const { return (Flags & LocationFlag) != 0; }
+	bool HasYaw() const { return (Flags & YawFlag) != 0; }
+	bool HasZoomPercent() const { return (Flags & ZoomFlag) != 0; }
+	bool HasSequence() const { return (Flags & SequenceFlag) != 0; }
+	bool HasServerTime() const { return (Flags & ServerTimeFlag) != 0; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FCameraNetState& Other) const;
+	bool operator!=(const FCameraNetState& Other) const { return !(*this == Other); }
+
+private:
+	enum : uint8
+	{
+		LocationFlag = 1 << 0,
+		YawFlag = 1 << 1,
+		ZoomFlag = 1 << 2,
+		SequenceFlag = 1 << 3,
+		ServerTimeFlag = 1 << 4,
+
+		NumFlagBits = 5
+	};
+
+	uint8 Flags {0};
+	FIntVector Location {FIntVector::ZeroValue};
+	uint16 Yaw {0};
+	uint8 ZoomPercent {0};
+	uint16 SequenceBits {0};
+	uint16 ServerTimeBits {0};
+};
+
+template<>
+struct TStructOpsTypeTraits<FCameraNetState> : public TStructOpsTypeTraitsBase2<FCameraNetState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+namespace CameraNet
+{
+	// Resolves the low 16 bits of a move sequence to the full sequence closest to Reference.
+	CRPG_API uint32 ResolveSequence(uint16 SequenceBits, uint32 Reference);
+	
+	// Number of bits a NetSerialize struct takes on the wire, for reporting message sizes.
+	template<typename TStruct>
+	int64 GetSerializedBits(const TStruct& Value)
+	{
+		TStruct Copy = Value;
+		FNetBitWriter Writer(nullptr, 4096);
+		bool bSuccess = true;
+		Copy.NetSerialize(Writer, nullptr, bSuccess);
+		return Writer.GetNumBits();
+	}
+
+	// Bits of every element in an array of NetSerialize structs, excluding the array count.
+	template<typename TStruct>
+	int64 GetSerializedBits(const TArray<TStruct>& Values)
+	{
+		int64 NumBits = 0;
+		for (const TStruct& Value : Values)
+		{
+			NumBits += GetSerializedBits(Value);
+		}
+		return NumBits;
+	}
+}
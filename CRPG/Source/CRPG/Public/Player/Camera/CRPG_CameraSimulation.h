@@ -0,0 +1,42 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCameraInputCommand;
+
+// The part of the camera state driven by player input.
+struct FCameraSimulationState
+{
+	FVector Location {FVector::ZeroVector};
+	float Yaw {0.f};
+	float ZoomPercent {0.f};
+};
+
+struct FCameraSimulationSettings
+{
+	float MovementSpeed {10.f};
+	float RotationSpeed {10.f};
+	float ZoomSpeed {0.1f};
+
+	// Length of one simulation sub-step in seconds.
+	float FixedStep {1.f / 60.f};
+};
+
+/**
+ * Stateless camera simulation shared by the owning client's prediction and the server.
+ * A command's quantized frame time is split into fixed sub-steps on an integer time base, so both machines
+ * produce bit-identical results for the same command regardless of their own frame rates. Movement within a sub-step
+ * is integrated exactly along the turn, so clients sending at different rates end up in the same place.
+ */
+namespace CameraSimulation
+{
+	CRPG_API FCameraSimulationState Step(const FCameraSimulationState& State, const FCameraInputCommand& Command, const FCameraSimulationSettings& Settings);
+
+	// Cubic ease in and out of Alpha in [0, 1], used to smooth MoveTo.
+	CRPG_API float EaseInOutCubic(float Alpha);
+
+	// Length of the normalized difference between two rotations, in degrees.
+	CRPG_API float GetAngularDistance(const FRotator& A, const FRotator& B);
+}
@@ -0,0 +1,55 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Camera state received from the server, stamped with the server time it was taken at.
+struct FCameraSnapshot
+{
+	double Time {0.0};
+	FVector Location {FVector::ZeroVector};
+	float Yaw {0.f};
+};
+
+/**
+ * Time-ordered snapshots of a remote camera. Sampling a fixed delay behind the server decouples playback from packet
+ * timing, so a camera replicated at a low rate still moves smoothly.
+ * Stored in a fixed-capacity ring buffer, so adding and trimming never move the other snapshots.
+ */
+struct CRPG_API FCameraSnapshotBuffer
+{
+public:
+	// Allocates the buffer. Capacity is rounded up to a power of two. When full the oldest snapshot is dropped.
+	void Init(int32 InCapacity);
+
+	void Reset();
+
+	// Appends a snapshot. Snapshots not newer than the newest one are ignored.
+	void Add(const FCameraSnapshot& Snapshot);
+
+	// Interpolates the snapshots around Time. Past the newest snapshot it extrapolates along the last segment for at most
+	// MaxExtrapolation seconds, then holds. Returns false if the buffer is empty.
+	bool Sample(double Time, double MaxExtrapolation, FCameraSnapshot& OutSnapshot) const;
+
+	// Drops snapshots that are no longer needed to sample Time or later.
+	void Trim(double Time);
+
+	bool IsEmpty() const { return Count == 0; }
+	int32 Num() const { return static_cast<int32>(Count); }
+	int32 GetCapacity() const { return Snapshots.Num(); }
+
+	// Requires a non-empty buffer.
+	const FCameraSnapshot& GetNewest() const { return Get(Num() - 1); }
+
+private:
+	// Index 0 is the oldest snapshot.
+	const FCameraSnapshot& Get(int32 Index) const { return Snapshots[(Oldest + Index) & IndexMask]; }
+
+	static FCameraSnapshot Interpolate(const FCameraSnapshot& From, const FCameraSnapshot& To, double Alpha);
+
+	TArray<FCameraSnapshot> Snapshots;
+	uint32 IndexMask {0};
+	uint32 Oldest {0};
+	uint32 Count {0};
+};
@@ -0,0 +1,17 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+// Cycle counters for the player camera. View with "stat CRPGCamera".
+DECLARE_STATS_GROUP(TEXT("CRPG Camera"), STATGROUP_CRPGCamera, STATCAT_Advanced);
+
+// Insights channel for camera prediction, correction and MoveTo events. Enable with -trace=default,CRPGCamera.
+UE_TRACE_CHANNEL_EXTERN(CRPGCameraChannel, CRPG_API);
+
+// CSV profiler counters for move history length, active corrections, camera RPCs per frame and terrain cache hit rate.
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(CRPG_API, CRPGCamera);
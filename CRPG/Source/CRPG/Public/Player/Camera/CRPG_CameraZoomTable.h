@@ -0,0 +1,35 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USplineComponent;
+
+/**
+ * Zoom spline baked into evenly spaced locations and look-at rotations, so a zoom is one interpolated lookup
+ * instead of a spline evaluation and a look-at.
+ */
+struct CRPG_API FCameraZoomTable
+{
+public:
+	// Samples the spline's local space into TableSpace, every sample looking at LookAtLocation (also in TableSpace).
+	void Bake(const USplineComponent& Spline, const FTransform& SplineToTableSpace, const FVector& LookAtLocation, int32 NumSamples);
+
+	void Reset();
+
+	bool IsBaked() const { return Locations.Num() >= 2; }
+
+	// Interpolated transform at ZoomPercentage in [0, 1]. Requires a baked table.
+	FTransform Sample(float ZoomPercentage) const;
+
+	// Smallest zoom percentage whose sample is at least Distance from the look-at location. Requires a baked table.
+	float FindZoomPercentForDistance(float Distance) const;
+
+private:
+	TArray<FVector> Locations;
+	TArray<FQuat> Rotations;
+
+	// Running maximum of each sample's distance to the look-at location, so it can be binary searched.
+	TArray<float> Distances;
+};
@@ -70,6 +70,10 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Interaction")
 	TObjectPtr<UInputAction> Select;
 
+	// Orders the selected party to the location under the cursor.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Interaction")
+	TObjectPtr<UInputAction> MoveSelected;
+
 public:
 	TObjectPtr<UInputMappingContext> GetTacticalInteractionInputMappingContext() const
 	{
@@ -81,5 +85,10 @@ public:
 		return Select;
 	}
 
+	TObjectPtr<UInputAction> GetMoveSelected() const
+	{
+		return MoveSelected;
+	}
+
 	/* --- END: Movement --- */
 };
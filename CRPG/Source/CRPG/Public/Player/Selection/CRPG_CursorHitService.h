@@ -0,0 +1,72 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/HitResult.h"
+#include "WorldCollision.h"
+#include "CRPG_CursorHitService.generated.h"
+
+// What is under the cursor, as of one frame's trace.
+struct FCursorHit
+{
+	// Frame the trace was issued on. The result arrives a frame later.
+	uint64 Frame {0};
+
+	// Cursor ray in world space.
+	FVector RayStart {FVector::ZeroVector};
+	FVector RayEnd {FVector::ZeroVector};
+
+	// First blocking hit along the ray, usually the ground.
+	FHitResult Hit;
+	bool bHit {false};
+
+	// Selectable actor under the cursor, if any.
+	TWeakObjectPtr<AActor> Selectable;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCursorHitUpdated, const FCursorHit&);
+
+/**
+ * Owned by the player controller: issues one async cursor trace per frame and serves its result to hover
+ * highlighting, selection, move previews and anything else that needs to know what is under the cursor.
+ * Selectable actors are resolved from UCRPG_SelectableActorSubsystem's spatial hash, not by tracing against them.
+ */
+UCLASS()
+class CRPG_API UCRPG_CursorHitService : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCRPG_CursorHitService();
+
+	// Issues this frame's trace. Called by the owning controller once per frame.
+	void Update();
+
+	// The newest completed hit. Check Frame when the result must not be stale.
+	const FCursorHit& GetHit() const { return CursorHit; }
+
+	// Broadcast when a new hit arrives.
+	FOnCursorHitUpdated OnCursorHitUpdated;
+
+protected:
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Cursor")
+	TEnumAsByte<ECollisionChannel> TraceChannel {ECC_Visibility};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Cursor", meta=(ClampMin="100"))
+	float TraceDistance {100000.f};
+
+private:
+	FCursorHit CursorHit;
+
+	FTraceDelegate TraceDelegate;
+
+	// Frame the trace in flight was issued on, and its ray.
+	uint64 PendingFrame;
+	FVector PendingRayStart;
+	FVector PendingRayEnd;
+	bool bTraceInFlight;
+
+	void OnTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+};
@@ -0,0 +1,42 @@
+﻿// Copyright. © 2024. Spxcebxr Games.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APlayerController;
+
+// Bounding spheres stored as separate arrays, so four of them load into one SIMD register per component.
+struct FSelectionBounds
+{
+	const float* X {nullptr};
+	const float* Y {nullptr};
+	const float* Z {nullptr};
+	const float* Radius {nullptr};
+	int32 Num {0};
+};
+
+/**
+ * The four side planes of the volume a screen rectangle sees through the player's camera, facing inwards.
+ * Near and far planes are left out since a marquee selects everything in front of the camera.
+ */
+struct CRPG_API FSelectionFrustum
+{
+	FPlane4f Planes[4];
+
+	// Builds the frustum from the world rays through the rectangle's corners, given in order around it.
+	static FSelectionFrustum FromCornerRays(const FVector (&Origins)[4], const FVector (&Directions)[4]);
+
+	// Deprojects the screen rectangle between two corners through PlayerController's view. False if it can't.
+	// Rectangles thinner than a couple of pixels are widened so every side plane is well defined.
+	static bool FromScreenRect(const APlayerController& PlayerController, const FVector2D& CornerA, const FVector2D& CornerB, FSelectionFrustum& OutFrustum);
+};
+
+namespace SelectionFrustum
+{
+	// Appends the index of every sphere inside or touching Frustum, testing four spheres per plane at a time.
+	CRPG_API void CullSpheres(const FSelectionFrustum& Frustum, const FSelectionBounds& Bounds, TArray<int32>& OutIndices);
+
+	// Scalar equivalent of CullSpheres, kept as a reference for the kernel benchmark.
+	CRPG_API void CullSpheresScalar(const FSelectionFrustum& Frustum, const FSelectionBounds& Bounds, TArray<int32>& OutIndices);
+}